@@ -7,6 +7,26 @@
 #include <memory>
 #include <iomanip>
 #include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <cmath>
+#include <string>
+#include <sstream>
+#include <stdexcept>
+#include <new>
+#include <type_traits>
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <map>
+#include <condition_variable>
+#include <exception>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
 
 /*
  * ================================
@@ -19,13 +39,82 @@ static const int TRAVEL_TIME = 30;       // 30 minutes (site <-> station)
 static const int UNLOAD_TIME = 5;        // 5 minutes
 static const int SIMULATION_TIME = 4320; // 72 hours in minutes (72 * 60)
 
+/*
+ * Durations of the truck cycle, in whole minutes, for one simulation.
+ * The defaults are the constants above; other values let a parameter sweep
+ * vary the site without recompiling.
+ */
+struct SiteTiming
+{
+    int miningTimeMin = MINING_TIME_MIN;
+    int miningTimeMax = MINING_TIME_MAX;
+    int travelTime = TRAVEL_TIME;
+    int unloadTime = UNLOAD_TIME;
+    int simulationTime = SIMULATION_TIME;
+
+    bool valid() const
+    {
+        // A zero-length cycle would schedule events at one instant forever
+        return 0 <= miningTimeMin && miningTimeMin <= miningTimeMax && travelTime >= 0 && unloadTime >= 0 &&
+               simulationTime >= 0 && miningTimeMin + 2 * travelTime + unloadTime > 0;
+    }
+};
+
+/*
+ * ================================
+ * DEBUG: allocation counter
+ * ================================
+ * Build with -DSIMULATION_COUNT_ALLOCATIONS to count every global operator new,
+ * e.g. to check that reset() + run() reuses all storage. allocationCount()
+ * returns 0 otherwise.
+ */
+#ifdef SIMULATION_COUNT_ALLOCATIONS
+static std::atomic<uint64_t> heapAllocations(0);
+
+void *operator new(size_t size)
+{
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(size_t size, std::align_val_t alignment)
+{
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    size_t align = static_cast<size_t>(alignment);
+    if (void *p = std::aligned_alloc(align, (size + align - 1) / align * align))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// Out of line, or GCC sees the free() of memory from operator new and warns
+#if defined(__GNUC__)
+#define SIMULATION_NOINLINE __attribute__((noinline))
+#else
+#define SIMULATION_NOINLINE
+#endif
+SIMULATION_NOINLINE void operator delete(void *p) noexcept { std::free(p); }
+SIMULATION_NOINLINE void operator delete(void *p, size_t) noexcept { std::free(p); }
+SIMULATION_NOINLINE void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+SIMULATION_NOINLINE void operator delete(void *p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+static uint64_t allocationCount() { return heapAllocations.load(std::memory_order_relaxed); }
+#else
+static uint64_t allocationCount() { return 0; }
+#endif
+
 /*
  * ================================
  * ENUM: EventType
  * ================================
  * Represents the types of events we handle in the simulation.
  */
-enum class EventType
+enum class EventType : uint8_t
 {
     FINISH_MINING,   // Truck finishes mining at the site
     ARRIVE_STATION,  // Truck arrives at an unload station
@@ -45,6 +134,8 @@ public:
     int id;
     int loadsDelivered;      // how many loads the truck has delivered
     double arrivalEventTime; // when turck arrived at station (used to calculate wait)
+    int stationId;           // station the truck is queued or unloading at, -1 otherwise
+    int nextInQueue;         // truck behind this one in its station's queue, -1 if last
 
     double totalWaitTime;   // total time spent waiting in queue
     double totalTravelTime; // total time spent traveling
@@ -53,7 +144,7 @@ public:
 
     // Constructor
     Truck(int _id)
-        : id(_id), loadsDelivered(0), arrivalEventTime(0.0), totalWaitTime(0.0),
+        : id(_id), loadsDelivered(0), arrivalEventTime(0.0), stationId(-1), nextInQueue(-1), totalWaitTime(0.0),
           totalTravelTime(0.0), totalMiningTime(0.0), totalUnloadTime(0.0)
     {
     }
@@ -71,351 +162,5623 @@ public:
     }
 };
 
+// Type that statistics of type T are summed in: int64_t for integer counters
+template <typename T>
+using SumType = typename std::conditional<std::is_integral<T>::value, int64_t, double>::type;
+
 /*
  * ================================
- * CLASS: Station
+ * STRUCT: FleetTotals
  * ================================
- * Represents an unload station where one truck can unload at a time.
+ * Statistics summed over every truck of a run (or of several runs, via +=).
+ * Total is SumType of the statistics: double, or int64_t for integer ticks.
  */
-class Station
+template <typename Total>
+struct FleetTotals
 {
-public:
-    int id;
-    bool isBusy;
-    double busyUntil;     // track until what time the station is busy
-    double totalBusyTime; // how long the station was busy (used for utilization calculation)
-
-    // Queue of trucks waiting for this station
-    std::queue<int> truckQueue; // store truck IDs in queue
+    int64_t loadsDelivered = 0;
+    Total totalWaitTime = 0;
+    Total totalTravelTime = 0;
+    Total totalMiningTime = 0;
+    Total totalUnloadTime = 0;
 
-    // Constructor
-    Station(int _id) : id(_id), isBusy(false), busyUntil(0.0), totalBusyTime(0.0) {}
-
-    // For debugging/logging
-    void printStats() const
+    FleetTotals &operator+=(const FleetTotals &other)
     {
-        std::cout << "Station " << id << " Statistics:\n"
-                  << "  Total Busy Time (min): " << totalBusyTime << "\n"
-                  << std::endl;
+        loadsDelivered += other.loadsDelivered;
+        totalWaitTime += other.totalWaitTime;
+        totalTravelTime += other.totalTravelTime;
+        totalMiningTime += other.totalMiningTime;
+        totalUnloadTime += other.totalUnloadTime;
+        return *this;
     }
 
-    // We need to order station based on shortest truckQueue
-    // bool operator>(const Station &other) const
-    // {
-    //     return this->truckQueue.size() > other.truckQueue.size();
-    // }
+    bool operator==(const FleetTotals &other) const
+    {
+        return loadsDelivered == other.loadsDelivered && totalWaitTime == other.totalWaitTime &&
+               totalTravelTime == other.totalTravelTime && totalMiningTime == other.totalMiningTime &&
+               totalUnloadTime == other.totalUnloadTime;
+    }
 };
 
 /*
  * ================================
- * STRUCT: Event
+ * CLASS: BasicTruckTable
  * ================================
- * Represents a single simulation event with a time, type, and associated IDs.
+ * All trucks of a simulation, stored as one array per field. A handler only
+ * reads and writes the fields it needs, so with millions of trucks an event
+ * pulls a few bytes of each truck into cache instead of a whole Truck record.
+ * The station-side state read on every arrival and unload (hot) is kept apart
+ * from the statistics, which are only ever added to (cold).
+ * Indexing or iterating yields Truck snapshots, for printing and tests.
+ *
+ * Tick is the type of the time statistics. Every duration in the model is a
+ * whole number of minutes, so an integer Tick (int32_t or int64_t) counts them
+ * exactly: int32_t halves the columns, and totals are summed into 64 bits,
+ * which gives the same bits in any order and lets the sums vectorize.
  */
-struct Event
+template <typename Tick>
+class BasicTruckTable
 {
-    double time;    // time in the simulation (minutes)
-    EventType type; // event type
-    int truckId;    // which truck is involved
-    int stationId;  // which station is involved, if applicable
+public:
+    using Total = SumType<Tick>;
 
-    // We need to order events in a priority queue by earliest time
-    bool operator>(const Event &other) const
+    // Hot: state of a truck at its station
+    std::vector<double> arrivalEventTime; // when truck arrived at station (used to calculate wait)
+    std::vector<int> stationId;           // station the truck is queued or unloading at, -1 otherwise
+    std::vector<int> nextInQueue;         // truck behind this one in its station's queue, -1 if last
+
+    // Cold: statistics
+    std::vector<int> loadsDelivered;
+    std::vector<Tick> totalWaitTime;
+    std::vector<Tick> totalTravelTime;
+    std::vector<Tick> totalMiningTime;
+    std::vector<Tick> totalUnloadTime;
+
+    explicit BasicTruckTable(int numTrucks)
+        : arrivalEventTime(numTrucks, 0.0), stationId(numTrucks, -1), nextInQueue(numTrucks, -1),
+          loadsDelivered(numTrucks, 0), totalWaitTime(numTrucks, 0), totalTravelTime(numTrucks, 0),
+          totalMiningTime(numTrucks, 0), totalUnloadTime(numTrucks, 0)
+    {
+    }
+
+    size_t size() const { return loadsDelivered.size(); }
+
+    // Back to the state of a new fleet, keeping the storage
+    void reset()
+    {
+        std::fill(arrivalEventTime.begin(), arrivalEventTime.end(), 0.0);
+        std::fill(stationId.begin(), stationId.end(), -1);
+        std::fill(nextInQueue.begin(), nextInQueue.end(), -1);
+        std::fill(loadsDelivered.begin(), loadsDelivered.end(), 0);
+        std::fill(totalWaitTime.begin(), totalWaitTime.end(), Tick(0));
+        std::fill(totalTravelTime.begin(), totalTravelTime.end(), Tick(0));
+        std::fill(totalMiningTime.begin(), totalMiningTime.end(), Tick(0));
+        std::fill(totalUnloadTime.begin(), totalUnloadTime.end(), Tick(0));
+    }
+
+    // Gathers one truck's fields into a Truck
+    Truck operator[](size_t truckId) const
+    {
+        Truck truck(static_cast<int>(truckId));
+        truck.loadsDelivered = loadsDelivered[truckId];
+        truck.arrivalEventTime = arrivalEventTime[truckId];
+        truck.stationId = stationId[truckId];
+        truck.nextInQueue = nextInQueue[truckId];
+        truck.totalWaitTime = static_cast<double>(totalWaitTime[truckId]);
+        truck.totalTravelTime = static_cast<double>(totalTravelTime[truckId]);
+        truck.totalMiningTime = static_cast<double>(totalMiningTime[truckId]);
+        truck.totalUnloadTime = static_cast<double>(totalUnloadTime[truckId]);
+        return truck;
+    }
+
+    // Sums every column over the fleet
+    FleetTotals<Total> totals() const
+    {
+        FleetTotals<Total> result;
+        result.loadsDelivered = sum(loadsDelivered);
+        result.totalWaitTime = sum(totalWaitTime);
+        result.totalTravelTime = sum(totalTravelTime);
+        result.totalMiningTime = sum(totalMiningTime);
+        result.totalUnloadTime = sum(totalUnloadTime);
+        return result;
+    }
+
+    // Iterates the trucks in ID order as Truck snapshots
+    class const_iterator
+    {
+    public:
+        const_iterator(const BasicTruckTable *_table, size_t _truckId) : table(_table), truckId(_truckId) {}
+
+        Truck operator*() const { return (*table)[truckId]; }
+        const_iterator &operator++()
+        {
+            ++truckId;
+            return *this;
+        }
+        bool operator==(const const_iterator &other) const { return truckId == other.truckId; }
+        bool operator!=(const const_iterator &other) const { return truckId != other.truckId; }
+
+    private:
+        const BasicTruckTable *table;
+        size_t truckId;
+    };
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+private:
+    // Plain loop over one contiguous column; with integer columns the compiler
+    // can widen and add several lanes at a time
+    template <typename T>
+    static SumType<T> sum(const std::vector<T> &column)
     {
-        return this->time > other.time;
+        SumType<T> total = 0;
+        for (T value : column)
+        {
+            total += value;
+        }
+        return total;
     }
 };
 
+using TruckTable = BasicTruckTable<double>;
+
 /*
  * ================================
- * CLASS: Simulation
+ * CLASS: TruckQueue
  * ================================
- * Manages the overall simulation, event queue, and data structures.
+ * FIFO of truck IDs for one station, stored intrusively: the queue keeps only
+ * head/tail, and each truck links to the one behind it (BasicTruckTable::nextInQueue).
+ * A truck is in at most one queue at a time, so push/pop are O(1) and never
+ * allocate.
  */
-class Simulation
+class TruckQueue
 {
-private:
-    // Priority queue of events, earliest event first
-    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> eventQueue;
-
-    // Priority queue of stations, earliest station first for trucks
-    // to implement minHeap for station with smallest queue
-
-    // The trucks and stations
-    std::vector<Truck> trucks;
-    std::vector<Station> stations;
-
-    // Random engine for mining durations
-    std::mt19937 rng;
-    std::uniform_int_distribution<int> miningDist;
+public:
+    TruckQueue() : head(-1), tail(-1), length(0) {}
 
-    // Current time in simulation
-    double currentTime;
+    bool empty() const { return length == 0; }
+    size_t size() const { return length; }
+    int front() const { return head; }
+    int back() const { return tail; }
 
-public:
-    Simulation(int numTrucks, int numStations)
-        : rng(std::random_device{}()), miningDist(MINING_TIME_MIN, MINING_TIME_MAX), currentTime(0.0)
+    void push(int truckId, std::vector<int> &nextInQueue)
     {
-        // Initialize trucks
-        for (int i = 0; i < numTrucks; ++i)
+        nextInQueue[truckId] = -1;
+        if (tail == -1)
         {
-            trucks.push_back(Truck(i));
+            head = truckId;
         }
-        // Initialize stations
-        for (int i = 0; i < numStations; ++i)
+        else
         {
-            stations.push_back(Station(i));
+            nextInQueue[tail] = truckId;
         }
+        tail = truckId;
+        ++length;
     }
 
-    /*
-     * Runs the simulation up to SIMULATION_TIME minutes.
-     */
-    void run()
+    void pop(std::vector<int> &nextInQueue)
     {
-        // Schedule initial FINISH_MINING events for each truck
-        for (auto &truck : trucks)
+        int next = nextInQueue[head];
+        nextInQueue[head] = -1;
+        head = next;
+        if (head == -1)
         {
-            int miningTime = miningDist(rng);
-            scheduleEvent(currentTime + miningTime, EventType::FINISH_MINING, truck.id, -1);
+            tail = -1;
         }
+        --length;
+    }
 
-        // Process events until we exceed SIMULATION_TIME
-        while (!eventQueue.empty())
-        {
-            Event evt = eventQueue.top();
-            eventQueue.pop();
+private:
+    int head;
+    int tail;
+    size_t length;
+};
 
-            // If the event is beyond our simulation window, we stop processing
-            if (evt.time > SIMULATION_TIME)
-            {
-                break;
-            }
+/*
+ * ================================
+ * CLASS: Station
+ * ================================
+ * Represents an unload station with one or more bays. Each bay unloads one
+ * truck at a time, and all bays are fed from the station's single queue.
+ */
+class Station
+{
+public:
+    int id;
+    int bays;             // how many trucks can unload at once
+    int unloadTime;       // minutes to unload one truck
+    int busyBays;         // bays claimed by an unloading truck
+    double totalBusyTime; // busy time summed over bays (used for utilization calculation)
 
-            // Advance currentTime
-            currentTime = evt.time;
+    std::vector<double> bayBusyUntil; // track until what time each bay is busy
+    std::vector<double> bayBusyTime;  // how long each bay was busy
 
-            // Handle event
-            handleEvent(evt);
-        }
-    }
+    // Queue of trucks waiting for a bay
+    TruckQueue truckQueue; // store truck IDs in queue
 
-    /*
-     * Prints statistics for all trucks and stations.
-     */
-    void printStats()
+    // Constructor
+    Station(int _id, int _bays = 1, int _unloadTime = UNLOAD_TIME)
+        : id(_id), bays(_bays), unloadTime(_unloadTime), busyBays(0), totalBusyTime(0.0), bayBusyUntil(_bays, 0.0),
+          bayBusyTime(_bays, 0.0)
     {
-        std::cout << "\n==================== Simulation Statistics ====================\n";
-        // Print Truck Stats
-        for (const auto &truck : trucks)
-        {
-            truck.printStats();
-        }
-        // Print Station Stats
-        for (auto &station : stations)
-        {
-            // If the station was busy until a certain time, we add that to totalBusyTime
-            // in case the station is still busy at the simulation end.
-            if (station.isBusy && station.busyUntil < SIMULATION_TIME)
-            {
-                station.totalBusyTime += (station.busyUntil - currentTime) < 0 ? 0 : (SIMULATION_TIME - currentTime);
-            }
-            station.printStats();
-            double utilization = (station.totalBusyTime / SIMULATION_TIME) * 100.0;
-            std::cout << "  Utilization: " << utilization << " %\n"
-                      << std::endl;
-        }
+    }
 
-        std::cout << "\n===============================================================\n\n\n";
+    // Back to an idle, empty station, keeping the storage
+    void reset()
+    {
+        busyBays = 0;
+        totalBusyTime = 0.0;
+        std::fill(bayBusyUntil.begin(), bayBusyUntil.end(), 0.0);
+        std::fill(bayBusyTime.begin(), bayBusyTime.end(), 0.0);
+        truckQueue = TruckQueue();
     }
 
-private:
-    /*
-     * Schedule a new event by pushing it into the priority queue.
-     */
-    void scheduleEvent(double time, EventType type, int truckId, int stationId)
+    // Trucks queued or unloading minus bays: negative while bays are free.
+    // With one bay this orders stations exactly like the queue length.
+    int backlog() const
     {
-        Event evt{time, type, truckId, stationId};
-        eventQueue.push(evt);
+        return static_cast<int>(truckQueue.size()) + busyBays - bays;
     }
 
     /*
-     * Handle the given event based on its type.
+     * Claims the lowest-numbered free bay from now until now + duration.
+     * Busy time past endTime falls outside the simulated window and is not counted.
      */
-    void handleEvent(const Event &evt)
+    void claimBay(double now, double duration, double endTime)
     {
-        switch (evt.type)
+        int bay = 0;
+        while (bayBusyUntil[bay] > now)
         {
-        case EventType::FINISH_MINING:
-            onFinishMining(evt.truckId);
-            break;
-        case EventType::ARRIVE_STATION:
-            onArriveStation(evt.truckId);
-            break;
-        case EventType::START_UNLOADING:
-            onStartUnloading(evt.truckId, evt.stationId);
-            break;
-        case EventType::FINISH_UNLOADING:
-            onFinishUnloading(evt.truckId, evt.stationId);
-            break;
-        default:
-            break;
+            ++bay;
         }
-    }
+        bayBusyUntil[bay] = now + duration;
 
-    /*
-     * A truck finishes mining at the site -> travel to station
-     */
-    void onFinishMining(int truckId)
-    {
-        trucks[truckId].totalTravelTime += TRAVEL_TIME;
-        scheduleEvent(currentTime + TRAVEL_TIME, EventType::ARRIVE_STATION, truckId, -1);
+        double counted = std::min(now + duration, endTime) - now;
+        bayBusyTime[bay] += counted;
+        totalBusyTime += counted;
+        ++busyBays;
     }
 
-    /*
-     * A truck arrives at the station -> find the station with the shortest queue
-     * or an available station, and queue up.
-     */
-    void onArriveStation(int truckId)
+    // For debugging/logging
+    void printStats() const
     {
-        // If there are 0 stations, Truck waits forever
-        if (stations.size() <= 0)
+        std::cout << "Station " << id << " Statistics:\n"
+                  << "  Total Busy Time (min): " << totalBusyTime << "\n";
+        if (bays > 1)
         {
-            trucks[truckId].totalWaitTime += SIMULATION_TIME - currentTime;
-            return;
+            for (int bay = 0; bay < bays; ++bay)
+            {
+                std::cout << "  Bay " << bay << " Busy Time (min): " << bayBusyTime[bay] << "\n";
+            }
         }
+        std::cout << std::endl;
+    }
 
-        // Find the station with the minimal queue time or an available station
-        int chosenStationId = findBestStation();
-
-        // record time truck arrives at station
-        trucks[truckId].arrivalEventTime = currentTime;
+    // We need to order station based on shortest truckQueue
+    // bool operator>(const Station &other) const
+    // {
+    //     return this->truckQueue.size() > other.truckQueue.size();
+    // }
+};
 
-        // Queue the truck at that station
-        stations[chosenStationId].truckQueue.push(truckId);
+/*
+ * ================================
+ * STRUCT: Event
+ * ================================
+ * Represents a single simulation event with a time, type, and truck ID (16 bytes).
+ * The station involved, if any, is part of the truck's state (Truck::stationId).
+ * generation is the truck's cancellation counter when the event was scheduled;
+ * once the counter moves on, the event is stale and is discarded when popped.
+ */
+struct Event
+{
+    double time;         // time in the simulation (minutes)
+    EventType type;      // event type
+    uint16_t generation; // truck's generation when scheduled
+    int truckId;         // which truck is involved
 
-        // If the station is not busy, the truck can start unloading immediately
-        if (!stations[chosenStationId].isBusy)
+    // We need to order events in a priority queue by earliest time
+    // (ties are broken by truck ID so runs are deterministic)
+    bool operator>(const Event &other) const
+    {
+        if (this->time != other.time)
         {
-            scheduleEvent(currentTime, EventType::START_UNLOADING,
-                          stations[chosenStationId].truckQueue.front(),
-                          chosenStationId);
+            return this->time > other.time;
         }
+        return this->truckId > other.truckId;
     }
+};
 
-    /*
-     * The chosen station starts unloading the front truck in its queue.
-     */
-    void onStartUnloading(int truckId, int stationId)
+/*
+ * ================================
+ * CLASS: IndexedEventHeap
+ * ================================
+ * Min-heap of pending events keyed by truck ID.
+ * Every truck has at most one outstanding event, so the heap never holds more
+ * than numTrucks entries. Pushing an event for a truck that already has one
+ * reschedules it in place instead of adding a second entry.
+ * All storage is allocated in the constructor; push/pop never allocate.
+ */
+class IndexedEventHeap
+{
+public:
+    explicit IndexedEventHeap(int capacity)
+        : heap(capacity), position(capacity, NOT_IN_HEAP), pendingType(capacity), pendingGeneration(capacity),
+          count(0)
     {
-        Station &station = stations[stationId];
-
-        // Mark station as busy
-        station.isBusy = true;
-
-        // Calculate how long the truck has been waiting
-        trucks[truckId].totalWaitTime += currentTime - trucks[truckId].arrivalEventTime;
-
-        // Truck starts unloading, schedule FINISH_UNLOADING
-        trucks[truckId].totalUnloadTime += UNLOAD_TIME;
-        double finishTime = currentTime + UNLOAD_TIME;
-
-        // Station will be busy until finishTime
-        station.busyUntil = finishTime;
+    }
 
-        // For this simple simulation, UNLOAD_TIME is added to totalBusyTime
-        station.totalBusyTime += (finishTime - currentTime); // station is busy for this duration
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
 
-        scheduleEvent(finishTime, EventType::FINISH_UNLOADING, truckId, stationId);
+    // Earliest pending event
+    Event top() const
+    {
+        const HeapEntry &entry = heap[0];
+        return Event{entry.time, pendingType[entry.truckId], pendingGeneration[entry.truckId], entry.truckId};
     }
 
     /*
-     * The truck finishes unloading -> increment loads delivered; then travel back to mine site.
+     * Schedule evt for its truck, replacing any event the truck already has pending.
+     * Returns true if it replaced one.
      */
-    void onFinishUnloading(int truckId, int stationId)
+    bool push(const Event &evt)
     {
-        Station &station = stations[stationId];
-
-        // One load delivered
-        trucks[truckId].loadsDelivered++;
+        pendingType[evt.truckId] = evt.type;
+        pendingGeneration[evt.truckId] = evt.generation;
 
-        // Remove truck from station queue
-        if (!station.truckQueue.empty())
+        int slot = position[evt.truckId];
+        if (slot == NOT_IN_HEAP)
         {
-            station.truckQueue.pop();
+            slot = static_cast<int>(count++);
+            heap[slot] = HeapEntry{evt.time, evt.truckId};
+            siftUp(slot);
+            return false;
         }
 
-        // If there's another truck in queue, schedule START_UNLOADING for that truck
-        if (!station.truckQueue.empty())
+        // Reschedule in place and restore heap order in whichever direction moved
+        double oldTime = heap[slot].time;
+        heap[slot].time = evt.time;
+        if (evt.time < oldTime)
         {
-            // The next truck can start unloading immediately at currentTime
-            scheduleEvent(currentTime, EventType::START_UNLOADING,
-                          station.truckQueue.front(), stationId);
+            siftUp(slot);
         }
         else
         {
-            // Mark station as not busy
-            station.isBusy = false;
+            siftDown(slot);
         }
-
-        // Truck travels back to site to mine again
-        trucks[truckId].totalTravelTime += TRAVEL_TIME;
-        double arrivalAtMineTime = currentTime + TRAVEL_TIME;
-
-        // After traveling back, it starts mining again for random duration
-        int nextMiningTime = miningDist(rng);
-        trucks[truckId].totalMiningTime += nextMiningTime;
-        scheduleEvent(arrivalAtMineTime + nextMiningTime, EventType::FINISH_MINING, truckId, -1);
+        return true;
     }
 
-    /*
-     * Finds the station with the shortest queue (or an available one).
-     * If multiple stations have the same queue size, pick one arbitrarily.
-     * (if more time rewrite to use minHeap to go from O(N) to log(N)
-     * this function may not find smallest queue times if queue sizes are same
-     * need to add a public variable that stores future complete time)
-     */
-    int findBestStation()
+    // Drop every pending event, keeping the storage
+    void clear()
     {
-        int bestStationId = -1;
-        size_t minQueueSize = std::numeric_limits<size_t>::max();
-
-        for (auto &station : stations)
+        for (size_t i = 0; i < count; ++i)
         {
-            size_t queueSize = station.truckQueue.size();
-            if (queueSize < minQueueSize)
-            {
-                minQueueSize = queueSize;
-                bestStationId = station.id;
-            }
+            position[heap[i].truckId] = NOT_IN_HEAP;
         }
-        return bestStationId;
+        count = 0;
     }
-};
 
-/*
- * ================================
- * MAIN: Test Cases
- * ================================
- *
- * if more time, would add test cases to each function
- *
- * using debugger to manually verifiy functionality
- */
-int main()
-{
-    // test class 0: General tests
-    //  Test 0.1: 3 trucks, 1 station
+    void pop()
     {
-        std::cout << "==== Test Case 0.1: 3 Trucks, 1 Station ====\n";
-        Simulation sim(3, 1);
-        sim.run();
-        sim.printStats();
+        position[heap[0].truckId] = NOT_IN_HEAP;
+        if (--count > 0)
+        {
+            heap[0] = heap[count];
+            siftDown(0);
+        }
     }
 
-    // Test 0.2: 5 trucks, 2 stations
+    // Drop every event for which isStale(evt) is true and re-heapify
+    template <typename Pred>
+    void compact(Pred isStale)
     {
-        std::cout << "==== Test Case 0.2: 5 Trucks, 2 Stations ====\n";
+        size_t kept = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const HeapEntry &entry = heap[i];
+            Event evt{entry.time, pendingType[entry.truckId], pendingGeneration[entry.truckId], entry.truckId};
+            if (isStale(evt))
+            {
+                position[entry.truckId] = NOT_IN_HEAP;
+            }
+            else
+            {
+                heap[kept++] = entry;
+            }
+        }
+        count = kept;
+        for (int slot = static_cast<int>(count) / 2 - 1; slot >= 0; --slot)
+        {
+            siftDown(slot);
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            position[heap[i].truckId] = static_cast<int>(i);
+        }
+    }
+
+private:
+    static constexpr int NOT_IN_HEAP = -1;
+
+    // Heap entries carry only the ordering key; type and generation live in per-truck arrays
+    struct HeapEntry
+    {
+        double time;
+        int truckId;
+
+        bool operator<(const HeapEntry &other) const
+        {
+            return time < other.time || (time == other.time && truckId < other.truckId);
+        }
+    };
+
+    std::vector<HeapEntry> heap;          // heap order, only [0, count) is live
+    std::vector<int> position;            // heap slot of each truck's event, or NOT_IN_HEAP
+    std::vector<EventType> pendingType;   // type of each truck's pending event
+    std::vector<uint16_t> pendingGeneration; // generation stamp of each truck's pending event
+    size_t count;
+
+    void siftUp(int slot)
+    {
+        HeapEntry entry = heap[slot];
+        while (slot > 0)
+        {
+            int parent = (slot - 1) / 2;
+            if (!(entry < heap[parent]))
+            {
+                break;
+            }
+            place(slot, heap[parent]);
+            slot = parent;
+        }
+        place(slot, entry);
+    }
+
+    void siftDown(int slot)
+    {
+        HeapEntry entry = heap[slot];
+        int n = static_cast<int>(count);
+        while (true)
+        {
+            int child = 2 * slot + 1;
+            if (child >= n)
+            {
+                break;
+            }
+            if (child + 1 < n && heap[child + 1] < heap[child])
+            {
+                ++child;
+            }
+            if (!(heap[child] < entry))
+            {
+                break;
+            }
+            place(slot, heap[child]);
+            slot = child;
+        }
+        place(slot, entry);
+    }
+
+    void place(int slot, const HeapEntry &entry)
+    {
+        heap[slot] = entry;
+        position[entry.truckId] = slot;
+    }
+};
+
+/*
+ * ================================
+ * CLASS: BinaryHeapEventQueue
+ * ================================
+ * The original engine: a binary heap of full Event records (what
+ * std::priority_queue does, on a vector we can also compact).
+ * Kept as the baseline for benchmarks.
+ */
+class BinaryHeapEventQueue
+{
+public:
+    explicit BinaryHeapEventQueue(int capacity)
+    {
+        heap.reserve(capacity);
+    }
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    const Event &top() const { return heap.front(); }
+
+    // Always adds an entry; returns false (nothing replaced)
+    bool push(const Event &evt)
+    {
+        heap.push_back(evt);
+        std::push_heap(heap.begin(), heap.end(), std::greater<Event>());
+        return false;
+    }
+
+    void pop()
+    {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<Event>());
+        heap.pop_back();
+    }
+
+    void clear() { heap.clear(); }
+
+    // Drop every event for which isStale(evt) is true and re-heapify
+    template <typename Pred>
+    void compact(Pred isStale)
+    {
+        heap.erase(std::remove_if(heap.begin(), heap.end(), isStale), heap.end());
+        std::make_heap(heap.begin(), heap.end(), std::greater<Event>());
+    }
+
+private:
+    std::vector<Event> heap;
+};
+
+/*
+ * ================================
+ * CLASS: PackedEventHeap
+ * ================================
+ * Binary min-heap of events packed into 8 bytes:
+ * 32-bit tick (whole minutes) | 24-bit truck ID | 8-bit type.
+ * Comparing the packed words gives the usual (time, truckId) order, and
+ * sift-up/down only moves 8-byte records, so much more of the heap fits in
+ * cache. Usable for fleets of up to MAX_TRUCKS trucks with whole-minute times.
+ * There is no room for a generation stamp, so events cannot be cancelled.
+ */
+class PackedEventHeap
+{
+public:
+    static const int MAX_TRUCKS = 1 << 24;
+
+    explicit PackedEventHeap(int capacity)
+    {
+        if (capacity > MAX_TRUCKS)
+        {
+            throw std::length_error("PackedEventHeap supports at most 2^24 trucks");
+        }
+        heap.reserve(capacity);
+    }
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+
+    // Earliest pending event
+    Event top() const
+    {
+        uint64_t packed = heap.front();
+        return Event{static_cast<double>(packed >> 32), static_cast<EventType>(packed & 0xFF), 0,
+                     static_cast<int>((packed >> 8) & 0xFFFFFF)};
+    }
+
+    // Always adds an entry; returns false (nothing replaced)
+    bool push(const Event &evt)
+    {
+        uint64_t tick = static_cast<uint64_t>(evt.time + 0.5);
+        heap.push_back((tick << 32) | (static_cast<uint64_t>(evt.truckId) << 8) | static_cast<uint64_t>(evt.type));
+        std::push_heap(heap.begin(), heap.end(), std::greater<uint64_t>());
+        return false;
+    }
+
+    void pop()
+    {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<uint64_t>());
+        heap.pop_back();
+    }
+
+    void clear() { heap.clear(); }
+
+private:
+    std::vector<uint64_t> heap; // min-heap of packed events
+};
+
+/*
+ * ================================
+ * CLASS: RadixEventQueue
+ * ================================
+ * Monotone radix heap over integer ticks (whole minutes).
+ * Simulation time never goes backwards, so every pushed key is >= the last key
+ * popped. Bucket i holds keys whose highest bit differing from that last key
+ * is bit i-1, which gives amortized O(1) push and O(log T) pop.
+ * Keys are (tick << 32 | truckId), giving the same (time, truckId) order as
+ * IndexedEventHeap. Event times must be whole minutes.
+ */
+class RadixEventQueue
+{
+public:
+    explicit RadixEventQueue(int capacity) : last(0), count(0)
+    {
+        buckets[0].reserve(capacity);
+    }
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    // Earliest pending event
+    Event top()
+    {
+        refill();
+        const Entry &entry = buckets[0].back();
+        return Event{static_cast<double>(entry.key >> 32), entry.type, entry.generation,
+                     static_cast<int>(entry.key & 0xFFFFFFFFu)};
+    }
+
+    // Always adds an entry; returns false (nothing replaced)
+    bool push(const Event &evt)
+    {
+        uint64_t tick = static_cast<uint64_t>(evt.time + 0.5);
+        Entry entry{(tick << 32) | static_cast<uint32_t>(evt.truckId), evt.type, evt.generation};
+        buckets[bucketFor(entry.key)].push_back(entry);
+        ++count;
+        return false;
+    }
+
+    void pop()
+    {
+        refill();
+        buckets[0].pop_back();
+        --count;
+    }
+
+    void clear()
+    {
+        for (std::vector<Entry> &bucket : buckets)
+        {
+            bucket.clear();
+        }
+        last = 0;
+        count = 0;
+    }
+
+    // Drop every event for which isStale(evt) is true; buckets stay valid
+    template <typename Pred>
+    void compact(Pred isStale)
+    {
+        for (std::vector<Entry> &bucket : buckets)
+        {
+            auto stale = [&](const Entry &entry) {
+                return isStale(Event{static_cast<double>(entry.key >> 32), entry.type, entry.generation,
+                                     static_cast<int>(entry.key & 0xFFFFFFFFu)});
+            };
+            size_t before = bucket.size();
+            bucket.erase(std::remove_if(bucket.begin(), bucket.end(), stale), bucket.end());
+            count -= before - bucket.size();
+        }
+    }
+
+private:
+    static const int NUM_BUCKETS = 65;
+
+    struct Entry
+    {
+        uint64_t key;
+        EventType type;
+        uint16_t generation;
+    };
+
+    std::vector<Entry> buckets[NUM_BUCKETS];
+    uint64_t last; // last key moved into bucket 0
+    size_t count;
+
+    // A key below `last` would be a same-minute follow-up of the event being
+    // handled (e.g. START_UNLOADING for a lower truck ID). Simulation dispatches
+    // those itself, but if one is pushed here it is simply due immediately.
+    int bucketFor(uint64_t key) const
+    {
+        if (key <= last)
+        {
+            return 0;
+        }
+        return 64 - countLeadingZeros(key ^ last);
+    }
+
+    // Make sure bucket 0 holds the minimum key
+    void refill()
+    {
+        if (!buckets[0].empty())
+        {
+            return;
+        }
+
+        int i = 1;
+        while (buckets[i].empty())
+        {
+            ++i;
+        }
+
+        std::vector<Entry> &bucket = buckets[i];
+        uint64_t minKey = bucket[0].key;
+        for (const Entry &entry : bucket)
+        {
+            minKey = std::min(minKey, entry.key);
+        }
+        last = minKey;
+
+        // Every entry moves to a strictly lower bucket relative to the new minimum
+        for (const Entry &entry : bucket)
+        {
+            buckets[bucketFor(entry.key)].push_back(entry);
+        }
+        bucket.clear();
+    }
+
+    static int countLeadingZeros(uint64_t x)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_clzll(x);
+#else
+        int n = 0;
+        for (uint64_t bit = uint64_t(1) << 63; bit != 0 && !(x & bit); bit >>= 1)
+        {
+            ++n;
+        }
+        return n;
+#endif
+    }
+};
+
+/*
+ * ================================
+ * CLASS: LadderEventQueue
+ * ================================
+ * Ladder queue (Tang, Goh & Thng) for real-valued event times.
+ * Far-future events are appended unsorted to Top. When the near future runs
+ * dry, Top is spread over a rung of buckets sized so that each holds about
+ * one event; a bucket that is still too crowded spawns a finer rung below it.
+ * Only the bucket about to be consumed is sorted, into Bottom.
+ * Enqueue and dequeue are O(1) amortized regardless of how many events are
+ * pending. Ties are ordered by truck ID, as in the other engines.
+ */
+class LadderEventQueue
+{
+public:
+    explicit LadderEventQueue(int capacity)
+        : topStart(0.0), topMin(std::numeric_limits<double>::infinity()),
+          topMax(-std::numeric_limits<double>::infinity()), numRungs(0), count(0)
+    {
+        topList.reserve(capacity);
+    }
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    // Earliest pending event
+    const Event &top()
+    {
+        refill();
+        return bottom.back();
+    }
+
+    // Always adds an entry; returns false (nothing replaced)
+    bool push(const Event &evt)
+    {
+        ++count;
+
+        if (evt.time >= topStart)
+        {
+            topList.push_back(evt);
+            topMin = std::min(topMin, evt.time);
+            topMax = std::max(topMax, evt.time);
+            return false;
+        }
+
+        for (int r = 0; r < numRungs; ++r)
+        {
+            Rung &rung = rungs[r];
+            if (evt.time >= rung.currentStart())
+            {
+                rung.buckets[rung.bucketFor(evt.time)].push_back(evt);
+                return false;
+            }
+        }
+
+        // Earlier than everything on the ladder: insert into the sorted Bottom
+        auto it = std::lower_bound(bottom.begin(), bottom.end(), evt, std::greater<Event>());
+        bottom.insert(it, evt);
+        return false;
+    }
+
+    void pop()
+    {
+        refill();
+        bottom.pop_back();
+        --count;
+    }
+
+    // Drop every pending event; rung buckets keep their capacity
+    void clear()
+    {
+        topList.clear();
+        topStart = 0.0;
+        topMin = std::numeric_limits<double>::infinity();
+        topMax = -std::numeric_limits<double>::infinity();
+        for (Rung &rung : rungs)
+        {
+            for (std::vector<Event> &bucket : rung.buckets)
+            {
+                bucket.clear();
+            }
+        }
+        numRungs = 0;
+        bottom.clear();
+        count = 0;
+    }
+
+    // Drop every event for which isStale(evt) is true; the ladder keeps its shape
+    template <typename Pred>
+    void compact(Pred isStale)
+    {
+        removeStale(topList, isStale);
+        topMin = std::numeric_limits<double>::infinity();
+        topMax = -std::numeric_limits<double>::infinity();
+        for (const Event &evt : topList)
+        {
+            topMin = std::min(topMin, evt.time);
+            topMax = std::max(topMax, evt.time);
+        }
+        for (int r = 0; r < numRungs; ++r)
+        {
+            for (size_t b = rungs[r].current; b < rungs[r].numBuckets; ++b)
+            {
+                removeStale(rungs[r].buckets[b], isStale);
+            }
+        }
+        removeStale(bottom, isStale);
+    }
+
+private:
+    static const int MAX_RUNGS = 8;
+    static const size_t THRESHOLD = 50; // largest bucket we are willing to sort
+
+    struct Rung
+    {
+        double start;
+        double width;
+        size_t current;    // first bucket not yet consumed
+        size_t numBuckets; // live buckets; `buckets` keeps spare capacity
+        std::vector<std::vector<Event>> buckets;
+
+        double currentStart() const { return start + current * width; }
+
+        size_t bucketFor(double time) const
+        {
+            double offset = (time - start) / width;
+            size_t b = offset <= 0.0 ? 0 : static_cast<size_t>(offset);
+            return std::min(std::max(b, current), numBuckets - 1);
+        }
+
+        void reset(double _start, double _width, size_t _numBuckets)
+        {
+            start = _start;
+            width = _width;
+            current = 0;
+            numBuckets = _numBuckets;
+            if (buckets.size() < numBuckets)
+            {
+                buckets.resize(numBuckets);
+            }
+        }
+    };
+
+    std::vector<Event> topList; // unsorted far future
+    double topStart;            // events at or after this time go to Top
+    double topMin;
+    double topMax;
+
+    Rung rungs[MAX_RUNGS]; // rung 0 is the coarsest
+    int numRungs;
+
+    std::vector<Event> bottom; // sorted latest-first, so the next event is at the back
+    size_t count;
+
+    // Make sure Bottom holds the earliest pending events
+    void refill()
+    {
+        while (bottom.empty())
+        {
+            if (numRungs == 0)
+            {
+                spreadTop();
+                if (numRungs == 0)
+                {
+                    return; // Top went straight to Bottom
+                }
+            }
+
+            Rung &rung = rungs[numRungs - 1];
+            while (rung.current < rung.numBuckets && rung.buckets[rung.current].empty())
+            {
+                ++rung.current;
+            }
+            if (rung.current == rung.numBuckets)
+            {
+                --numRungs; // this rung is exhausted
+                continue;
+            }
+
+            std::vector<Event> &bucket = rung.buckets[rung.current];
+            double bucketStart = rung.currentStart();
+            ++rung.current;
+
+            if (bucket.size() > THRESHOLD && numRungs < MAX_RUNGS && spansTime(bucket))
+            {
+                // Too many to sort: spread this bucket over a finer rung
+                Rung &child = rungs[numRungs++];
+                child.reset(bucketStart, rung.width / bucket.size(), bucket.size() + 1);
+                for (const Event &evt : bucket)
+                {
+                    child.buckets[child.bucketFor(evt.time)].push_back(evt);
+                }
+            }
+            else
+            {
+                bottom.assign(bucket.begin(), bucket.end());
+                std::sort(bottom.begin(), bottom.end(), std::greater<Event>());
+            }
+            bucket.clear();
+        }
+    }
+
+    // Move the unsorted Top onto rung 0 (or straight to Bottom if it is tiny)
+    void spreadTop()
+    {
+        if (topList.size() <= THRESHOLD || topMax == topMin)
+        {
+            bottom.assign(topList.begin(), topList.end());
+            std::sort(bottom.begin(), bottom.end(), std::greater<Event>());
+            topStart = std::nextafter(topMax, std::numeric_limits<double>::infinity());
+        }
+        else
+        {
+            double width = (topMax - topMin) / topList.size();
+            Rung &rung = rungs[numRungs++];
+            rung.reset(topMin, width, topList.size() + 1);
+            for (const Event &evt : topList)
+            {
+                rung.buckets[rung.bucketFor(evt.time)].push_back(evt);
+            }
+            topStart = topMin + rung.numBuckets * width;
+        }
+
+        topList.clear();
+        topMin = std::numeric_limits<double>::infinity();
+        topMax = -std::numeric_limits<double>::infinity();
+    }
+
+    template <typename Pred>
+    void removeStale(std::vector<Event> &events, Pred isStale)
+    {
+        size_t before = events.size();
+        events.erase(std::remove_if(events.begin(), events.end(), isStale), events.end());
+        count -= before - events.size();
+    }
+
+    static bool spansTime(const std::vector<Event> &bucket)
+    {
+        for (const Event &evt : bucket)
+        {
+            if (evt.time != bucket[0].time)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+/*
+ * ================================
+ * CLASS: ShortestQueueSelection
+ * ================================
+ * Station selection policy: picks the station with the fewest trucks queued or
+ * unloading relative to its bays (Station::backlog()), lowest ID on ties.
+ * A selection policy is constructed from the station count and the run's seed
+ * (for randomized policies) and provides
+ * select(stations, now), plus update(station, now), which the simulation
+ * calls whenever a station's queue or busy state changes, for policies that
+ * keep an index, and reset(seed), which starts over as if newly constructed
+ * (the simulation then calls update() for every station).
+ * This one is a plain O(N) scan, so update() does nothing.
+ */
+class ShortestQueueSelection
+{
+public:
+    ShortestQueueSelection(int /*numStations*/, unsigned /*seed*/) {}
+
+    void reset(unsigned /*seed*/) {}
+
+    int select(const std::vector<Station> &stations, double /*now*/)
+    {
+        int bestStationId = -1;
+        int minBacklog = std::numeric_limits<int>::max();
+
+        for (const auto &station : stations)
+        {
+            int backlog = station.backlog();
+            if (backlog < minBacklog)
+            {
+                minBacklog = backlog;
+                bestStationId = station.id;
+            }
+        }
+        return bestStationId;
+    }
+
+    void update(const Station & /*station*/, double /*now*/) {}
+};
+
+/*
+ * ================================
+ * CLASS: AlignedAllocator
+ * ================================
+ * std::allocator replacement that aligns storage to ALIGNMENT bytes, so SIMD
+ * kernels can use aligned loads.
+ */
+template <typename T, size_t ALIGNMENT>
+struct AlignedAllocator
+{
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef AlignedAllocator<U, ALIGNMENT> other;
+    };
+
+    AlignedAllocator() {}
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, ALIGNMENT> &) {}
+
+    T *allocate(size_t n)
+    {
+        return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(ALIGNMENT)));
+    }
+
+    void deallocate(T *p, size_t)
+    {
+        ::operator delete(p, std::align_val_t(ALIGNMENT));
+    }
+
+    bool operator==(const AlignedAllocator &) const { return true; }
+    bool operator!=(const AlignedAllocator &) const { return false; }
+};
+
+/*
+ * ================================
+ * CLASS: SimdShortestQueueSelection
+ * ================================
+ * Same choice as ShortestQueueSelection (lowest backlog, lowest ID on ties), but
+ * backlogs are mirrored into one contiguous, 32-byte aligned int32 array
+ * that update() keeps current. select() is then a vector min over the array
+ * followed by a compare-and-movemask scan for the first station at that
+ * minimum: AVX2 (8 stations per compare) or SSE4.1 (4) when compiled with
+ * -mavx2 / -msse4.1 (or -march=native), scalar otherwise.
+ */
+class SimdShortestQueueSelection
+{
+public:
+    SimdShortestQueueSelection(int numStations, unsigned /*seed*/)
+        : // Padding lanes hold INT32_MAX so they never win
+          queueLength((numStations + LANES - 1) / LANES * LANES, std::numeric_limits<int32_t>::max())
+    {
+        std::fill(queueLength.begin(), queueLength.begin() + numStations, 0);
+    }
+
+    void reset(unsigned /*seed*/) {} // every station is updated right after
+
+    int select(const std::vector<Station> & /*stations*/, double /*now*/)
+    {
+        return argminFirst(queueLength.data(), static_cast<int>(queueLength.size()));
+    }
+
+    void update(const Station &station, double /*now*/)
+    {
+        queueLength[station.id] = station.backlog();
+    }
+
+private:
+    static const int LANES = 8;
+
+    std::vector<int32_t, AlignedAllocator<int32_t, 32>> queueLength;
+
+    // Index of the first minimum in values[0, count); count is a multiple of LANES
+    static int argminFirst(const int32_t *values, int count)
+    {
+#if defined(__AVX2__)
+        __m256i vmin = _mm256_set1_epi32(std::numeric_limits<int32_t>::max());
+        for (int i = 0; i < count; i += 8)
+        {
+            vmin = _mm256_min_epi32(vmin, _mm256_load_si256(reinterpret_cast<const __m256i *>(values + i)));
+        }
+        __m128i half = _mm_min_epi32(_mm256_castsi256_si128(vmin), _mm256_extracti128_si256(vmin, 1));
+        half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+        half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+        __m256i target = _mm256_set1_epi32(_mm_cvtsi128_si32(half));
+        for (int i = 0; i < count; i += 8)
+        {
+            __m256i hit = _mm256_cmpeq_epi32(target, _mm256_load_si256(reinterpret_cast<const __m256i *>(values + i)));
+            int mask = _mm256_movemask_ps(_mm256_castsi256_ps(hit));
+            if (mask != 0)
+            {
+                return i + countTrailingZeros(mask);
+            }
+        }
+        return -1;
+#elif defined(__SSE4_1__)
+        __m128i vmin = _mm_set1_epi32(std::numeric_limits<int32_t>::max());
+        for (int i = 0; i < count; i += 4)
+        {
+            vmin = _mm_min_epi32(vmin, _mm_load_si128(reinterpret_cast<const __m128i *>(values + i)));
+        }
+        vmin = _mm_min_epi32(vmin, _mm_shuffle_epi32(vmin, _MM_SHUFFLE(1, 0, 3, 2)));
+        vmin = _mm_min_epi32(vmin, _mm_shuffle_epi32(vmin, _MM_SHUFFLE(2, 3, 0, 1)));
+        __m128i target = _mm_set1_epi32(_mm_cvtsi128_si32(vmin));
+        for (int i = 0; i < count; i += 4)
+        {
+            __m128i hit = _mm_cmpeq_epi32(target, _mm_load_si128(reinterpret_cast<const __m128i *>(values + i)));
+            int mask = _mm_movemask_ps(_mm_castsi128_ps(hit));
+            if (mask != 0)
+            {
+                return i + countTrailingZeros(mask);
+            }
+        }
+        return -1;
+#else
+        int best = -1;
+        int32_t minValue = std::numeric_limits<int32_t>::max();
+        for (int i = 0; i < count; ++i)
+        {
+            if (values[i] < minValue)
+            {
+                minValue = values[i];
+                best = i;
+            }
+        }
+        return best;
+#endif
+    }
+
+    static int countTrailingZeros(unsigned x)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctz(x);
+#else
+        int n = 0;
+        while (!(x & 1u))
+        {
+            x >>= 1;
+            ++n;
+        }
+        return n;
+#endif
+    }
+};
+
+/*
+ * ================================
+ * CLASS: ProjectedFreeTimeSelection
+ * ================================
+ * Station selection policy: picks the station where a new arrival would start
+ * unloading soonest, given when each bay frees up and who is already waiting.
+ * Unlike queue length, this does not treat a station 1 minute from done the
+ * same as one that just started. Among stations already free, the lowest ID
+ * wins, like ShortestQueueSelection.
+ * Keys live in a tournament tree (each internal node holds the winner of its
+ * subtree), so update() and select() are O(log S).
+ */
+class ProjectedFreeTimeSelection
+{
+public:
+    ProjectedFreeTimeSelection(int numStations, unsigned /*seed*/) : numLeaves(1)
+    {
+        while (numLeaves < numStations)
+        {
+            numLeaves *= 2;
+        }
+        // Padding leaves never win
+        freeTime.assign(numLeaves, std::numeric_limits<double>::infinity());
+        std::fill(freeTime.begin(), freeTime.begin() + numStations, 0.0);
+        winner.resize(2 * numLeaves);
+        for (int leaf = 0; leaf < numLeaves; ++leaf)
+        {
+            winner[numLeaves + leaf] = leaf;
+        }
+        for (int node = numLeaves - 1; node >= 1; --node)
+        {
+            winner[node] = better(winner[2 * node], winner[2 * node + 1]);
+        }
+    }
+
+    void reset(unsigned /*seed*/) {} // every station is updated right after
+
+    int select(const std::vector<Station> & /*stations*/, double now)
+    {
+        // Nobody free yet: the overall winner frees up first
+        if (freeTime[winner[1]] > now)
+        {
+            return winner[1];
+        }
+
+        // Otherwise descend to the leftmost station that is already free
+        int node = 1;
+        while (node < numLeaves)
+        {
+            node = freeTime[winner[2 * node]] <= now ? 2 * node : 2 * node + 1;
+        }
+        return node - numLeaves;
+    }
+
+    void update(const Station &station, double now)
+    {
+        // Every unload takes the same time and every bay frees up within one unload
+        // of now, so waiting truck j gets the (j mod c)-th bay to free up, one
+        // round of c trucks per unload. A new arrival is truck j = waiting.
+        bayFree.resize(station.bays);
+        for (int bay = 0; bay < station.bays; ++bay)
+        {
+            bayFree[bay] = std::max(now, station.bayBusyUntil[bay]);
+        }
+        size_t waiting = station.truckQueue.size();
+        size_t round = waiting / station.bays;
+        auto nth = bayFree.begin() + waiting % station.bays;
+        std::nth_element(bayFree.begin(), nth, bayFree.end());
+        freeTime[station.id] = *nth + round * station.unloadTime;
+
+        for (int node = (numLeaves + station.id) / 2; node >= 1; node /= 2)
+        {
+            winner[node] = better(winner[2 * node], winner[2 * node + 1]);
+        }
+    }
+
+private:
+    int numLeaves;
+    std::vector<double> freeTime; // projected free time per station (leaf)
+    std::vector<int> winner;      // station winning each subtree; node 1 is the root
+    std::vector<double> bayFree;  // scratch for update()
+
+    int better(int a, int b) const
+    {
+        return freeTime[b] < freeTime[a] ? b : a; // ties keep the lower ID
+    }
+};
+
+/*
+ * ================================
+ * CLASS: PowerOfDChoicesSelection
+ * ================================
+ * Station selection policy for very large sites: samples D stations uniformly
+ * at random (with replacement) and picks the one with the lowest backlog,
+ * the first sampled on ties. O(D) per arrival whatever the station count, at
+ * the cost of slightly longer waits than exact join-shortest-queue; D = 2
+ * already gets most of the benefit over picking one station at random.
+ */
+template <int D = 2>
+class PowerOfDChoicesSelection
+{
+public:
+    PowerOfDChoicesSelection(int _numStations, unsigned seed)
+        : numStations(static_cast<uint64_t>(_numStations)), state(initialState(seed))
+    {
+    }
+
+    void reset(unsigned seed) { state = initialState(seed); }
+
+    int select(const std::vector<Station> &stations, double /*now*/)
+    {
+        int best = sample();
+        int bestBacklog = stations[best].backlog();
+        for (int i = 1; i < D; ++i)
+        {
+            int candidate = sample();
+            int backlog = stations[candidate].backlog();
+            if (backlog < bestBacklog)
+            {
+                best = candidate;
+                bestBacklog = backlog;
+            }
+        }
+        return best;
+    }
+
+    void update(const Station & /*station*/, double /*now*/) {}
+
+private:
+    uint64_t numStations;
+    uint64_t state;
+
+    // Decorrelate from the mining-time stream, which uses the same seed
+    static uint64_t initialState(unsigned seed)
+    {
+        return (static_cast<uint64_t>(seed) << 1 | 1) * 0x9E3779B97F4A7C15ull;
+    }
+
+    // xorshift64* step, mapped onto [0, numStations) with a multiply-shift
+    int sample()
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        uint64_t bits = (state * 0x2545F4914F6CDD1Dull) >> 32;
+        return static_cast<int>((bits * numStations) >> 32);
+    }
+};
+
+/*
+ * ================================
+ * CLASS: MersenneTwisterRng
+ * ================================
+ * RNG policy: draws mining durations from one std::mt19937 shared by the fleet.
+ * An RNG policy is constructed from a seed and the site timing (for the mining
+ * time range) and provides miningTime(truckId, cycle) and reset(seed). cycle
+ * is the number of loads the truck has delivered (0 for its first mining run),
+ * so (truck, cycle) names the draw; counter-based policies such as PhiloxRng
+ * compute it from those alone, stream policies like this one ignore both.
+ */
+class MersenneTwisterRng
+{
+public:
+    explicit MersenneTwisterRng(unsigned seed, const SiteTiming &timing = SiteTiming())
+        : rng(seed), miningDist(timing.miningTimeMin, timing.miningTimeMax)
+    {
+    }
+
+    void reset(unsigned seed)
+    {
+        rng.seed(seed);
+        miningDist.reset();
+    }
+
+    int miningTime(int /*truckId*/, int /*cycle*/) { return miningDist(rng); }
+
+private:
+    std::mt19937 rng;
+    std::uniform_int_distribution<int> miningDist;
+};
+
+/*
+ * ================================
+ * NAMESPACE: simd (LaneInts / LaneMask)
+ * ================================
+ * LANE_COUNT int32 values handled as one: a __m512i with AVX-512 (16 lanes),
+ * a __m256i with AVX2 (8 lanes), or a plain array otherwise (8 lanes, same
+ * results). LaneMask is a per-lane condition; simd::select(mask, a, b) picks
+ * a in the lanes where it holds. Only what LockstepReplications and
+ * BufferedXoshiroRng need is provided.
+ */
+namespace simd
+{
+#if defined(__AVX512F__)
+static const int LANE_COUNT = 16;
+
+struct LaneMask
+{
+    __mmask16 bits;
+};
+
+struct LaneInts
+{
+    __m512i v;
+};
+
+inline LaneInts broadcast(int32_t x) { return LaneInts{_mm512_set1_epi32(x)}; }
+inline LaneInts loadLanes(const int32_t *p) { return LaneInts{_mm512_load_si512(p)}; }
+inline void storeLanes(int32_t *p, LaneInts a) { _mm512_store_si512(p, a.v); }
+
+inline LaneInts operator+(LaneInts a, LaneInts b) { return LaneInts{_mm512_add_epi32(a.v, b.v)}; }
+inline LaneInts operator-(LaneInts a, LaneInts b) { return LaneInts{_mm512_sub_epi32(a.v, b.v)}; }
+inline LaneInts operator*(LaneInts a, LaneInts b) { return LaneInts{_mm512_mullo_epi32(a.v, b.v)}; }
+inline LaneInts operator^(LaneInts a, LaneInts b) { return LaneInts{_mm512_xor_si512(a.v, b.v)}; }
+inline LaneInts operator|(LaneInts a, LaneInts b) { return LaneInts{_mm512_or_si512(a.v, b.v)}; }
+// The zero-masked forms of the shifts, multiplies and min are the same instructions; GCC 12
+// reports the unmasked ones as reading uninitialized values
+inline LaneInts operator<<(LaneInts a, int k) { return LaneInts{_mm512_maskz_slli_epi32(0xFFFF, a.v, k)}; }
+inline LaneInts operator>>(LaneInts a, int k) { return LaneInts{_mm512_maskz_srli_epi32(0xFFFF, a.v, k)}; } // logical
+inline LaneInts min(LaneInts a, LaneInts b) { return LaneInts{_mm512_maskz_min_epi32(0xFFFF, a.v, b.v)}; }
+
+// High 32 bits of the unsigned 64-bit products
+inline LaneInts mulHigh(LaneInts a, LaneInts b)
+{
+    __m512i even = _mm512_maskz_srli_epi64(0xFF, _mm512_maskz_mul_epu32(0xFF, a.v, b.v), 32);
+    __m512i odd = _mm512_maskz_mul_epu32(0xFF, _mm512_maskz_srli_epi64(0xFF, a.v, 32),
+                                         _mm512_maskz_srli_epi64(0xFF, b.v, 32));
+    return LaneInts{_mm512_mask_blend_epi32(0xAAAA, even, odd)};
+}
+
+inline LaneMask operator<(LaneInts a, LaneInts b) { return LaneMask{_mm512_cmplt_epi32_mask(a.v, b.v)}; }
+inline LaneMask operator==(LaneInts a, LaneInts b) { return LaneMask{_mm512_cmpeq_epi32_mask(a.v, b.v)}; }
+inline LaneInts select(LaneMask m, LaneInts a, LaneInts b) { return LaneInts{_mm512_mask_blend_epi32(m.bits, b.v, a.v)}; }
+
+inline LaneMask operator&(LaneMask a, LaneMask b) { return LaneMask{static_cast<__mmask16>(a.bits & b.bits)}; }
+inline LaneMask operator|(LaneMask a, LaneMask b) { return LaneMask{static_cast<__mmask16>(a.bits | b.bits)}; }
+inline LaneMask operator!(LaneMask a) { return LaneMask{static_cast<__mmask16>(~a.bits)}; }
+inline bool any(LaneMask m) { return m.bits != 0; }
+#elif defined(__AVX2__)
+static const int LANE_COUNT = 8;
+
+struct LaneMask
+{
+    __m256i bits; // all ones in the lanes where the condition holds
+};
+
+struct LaneInts
+{
+    __m256i v;
+};
+
+inline LaneInts broadcast(int32_t x) { return LaneInts{_mm256_set1_epi32(x)}; }
+inline LaneInts loadLanes(const int32_t *p) { return LaneInts{_mm256_load_si256(reinterpret_cast<const __m256i *>(p))}; }
+inline void storeLanes(int32_t *p, LaneInts a) { _mm256_store_si256(reinterpret_cast<__m256i *>(p), a.v); }
+
+inline LaneInts operator+(LaneInts a, LaneInts b) { return LaneInts{_mm256_add_epi32(a.v, b.v)}; }
+inline LaneInts operator-(LaneInts a, LaneInts b) { return LaneInts{_mm256_sub_epi32(a.v, b.v)}; }
+inline LaneInts operator*(LaneInts a, LaneInts b) { return LaneInts{_mm256_mullo_epi32(a.v, b.v)}; }
+inline LaneInts operator^(LaneInts a, LaneInts b) { return LaneInts{_mm256_xor_si256(a.v, b.v)}; }
+inline LaneInts operator|(LaneInts a, LaneInts b) { return LaneInts{_mm256_or_si256(a.v, b.v)}; }
+inline LaneInts operator<<(LaneInts a, int k) { return LaneInts{_mm256_slli_epi32(a.v, k)}; }
+inline LaneInts operator>>(LaneInts a, int k) { return LaneInts{_mm256_srli_epi32(a.v, k)}; } // logical
+inline LaneInts min(LaneInts a, LaneInts b) { return LaneInts{_mm256_min_epi32(a.v, b.v)}; }
+
+// High 32 bits of the unsigned 64-bit products
+inline LaneInts mulHigh(LaneInts a, LaneInts b)
+{
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(a.v, b.v), 32);
+    __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a.v, 32), _mm256_srli_epi64(b.v, 32));
+    return LaneInts{_mm256_blend_epi32(even, odd, 0xAA)};
+}
+
+inline LaneMask operator<(LaneInts a, LaneInts b) { return LaneMask{_mm256_cmpgt_epi32(b.v, a.v)}; }
+inline LaneMask operator==(LaneInts a, LaneInts b) { return LaneMask{_mm256_cmpeq_epi32(a.v, b.v)}; }
+inline LaneInts select(LaneMask m, LaneInts a, LaneInts b) { return LaneInts{_mm256_blendv_epi8(b.v, a.v, m.bits)}; }
+
+inline LaneMask operator&(LaneMask a, LaneMask b) { return LaneMask{_mm256_and_si256(a.bits, b.bits)}; }
+inline LaneMask operator|(LaneMask a, LaneMask b) { return LaneMask{_mm256_or_si256(a.bits, b.bits)}; }
+inline LaneMask operator!(LaneMask a) { return LaneMask{_mm256_xor_si256(a.bits, _mm256_set1_epi32(-1))}; }
+inline bool any(LaneMask m) { return !_mm256_testz_si256(m.bits, m.bits); }
+#else
+static const int LANE_COUNT = 8;
+
+struct LaneMask
+{
+    uint32_t bits; // bit i set if the condition holds in lane i
+};
+
+struct LaneInts
+{
+    int32_t v[LANE_COUNT];
+};
+
+// Applies op lane by lane
+template <typename Op>
+inline LaneInts perLane(Op op)
+{
+    LaneInts result;
+    for (int lane = 0; lane < LANE_COUNT; ++lane)
+    {
+        result.v[lane] = op(lane);
+    }
+    return result;
+}
+
+template <typename Op>
+inline LaneMask perLaneMask(Op op)
+{
+    LaneMask result{0};
+    for (int lane = 0; lane < LANE_COUNT; ++lane)
+    {
+        result.bits |= static_cast<uint32_t>(op(lane)) << lane;
+    }
+    return result;
+}
+
+inline uint32_t asUnsigned(int32_t x) { return static_cast<uint32_t>(x); }
+inline int32_t asSigned(uint32_t x) { return static_cast<int32_t>(x); }
+
+inline LaneInts broadcast(int32_t x) { return perLane([&](int) { return x; }); }
+inline LaneInts loadLanes(const int32_t *p) { return perLane([&](int lane) { return p[lane]; }); }
+inline void storeLanes(int32_t *p, LaneInts a) { std::copy(a.v, a.v + LANE_COUNT, p); }
+
+inline LaneInts operator+(LaneInts a, LaneInts b) { return perLane([&](int i) { return asSigned(asUnsigned(a.v[i]) + asUnsigned(b.v[i])); }); }
+inline LaneInts operator-(LaneInts a, LaneInts b) { return perLane([&](int i) { return asSigned(asUnsigned(a.v[i]) - asUnsigned(b.v[i])); }); }
+inline LaneInts operator*(LaneInts a, LaneInts b) { return perLane([&](int i) { return asSigned(asUnsigned(a.v[i]) * asUnsigned(b.v[i])); }); }
+inline LaneInts operator^(LaneInts a, LaneInts b) { return perLane([&](int i) { return a.v[i] ^ b.v[i]; }); }
+inline LaneInts operator|(LaneInts a, LaneInts b) { return perLane([&](int i) { return a.v[i] | b.v[i]; }); }
+inline LaneInts operator<<(LaneInts a, int k) { return perLane([&](int i) { return asSigned(asUnsigned(a.v[i]) << k); }); }
+inline LaneInts operator>>(LaneInts a, int k) { return perLane([&](int i) { return asSigned(asUnsigned(a.v[i]) >> k); }); }
+inline LaneInts min(LaneInts a, LaneInts b) { return perLane([&](int i) { return std::min(a.v[i], b.v[i]); }); }
+
+// High 32 bits of the unsigned 64-bit products
+inline LaneInts mulHigh(LaneInts a, LaneInts b)
+{
+    return perLane([&](int i) {
+        return asSigned(static_cast<uint32_t>((static_cast<uint64_t>(asUnsigned(a.v[i])) * asUnsigned(b.v[i])) >> 32));
+    });
+}
+
+inline LaneMask operator<(LaneInts a, LaneInts b) { return perLaneMask([&](int i) { return a.v[i] < b.v[i]; }); }
+inline LaneMask operator==(LaneInts a, LaneInts b) { return perLaneMask([&](int i) { return a.v[i] == b.v[i]; }); }
+inline LaneInts select(LaneMask m, LaneInts a, LaneInts b) { return perLane([&](int i) { return (m.bits >> i & 1u) ? a.v[i] : b.v[i]; }); }
+
+inline LaneMask operator&(LaneMask a, LaneMask b) { return LaneMask{a.bits & b.bits}; }
+inline LaneMask operator|(LaneMask a, LaneMask b) { return LaneMask{a.bits | b.bits}; }
+inline LaneMask operator!(LaneMask a) { return LaneMask{~a.bits & ((1u << LANE_COUNT) - 1)}; }
+inline bool any(LaneMask m) { return m.bits != 0; }
+#endif
+} // namespace simd
+
+/*
+ * ================================
+ * CLASS: Xoshiro128Rng
+ * ================================
+ * RNG policy: xoshiro128** (four 32-bit words of state), with each output
+ * mapped onto the mining range by Lemire's multiply-shift (no rejection loop;
+ * the bias is below range / 2^32). Only 32-bit adds, shifts, xors and
+ * multiplies, so LockstepReplications runs one of these per SIMD lane; each
+ * lane draws exactly what this class draws for the same seed. Seeds above
+ * 2^32 give further independent streams (BufferedXoshiroRng's lanes).
+ */
+class Xoshiro128Rng
+{
+public:
+    explicit Xoshiro128Rng(uint64_t seed, const SiteTiming &timing = SiteTiming())
+        : miningTimeMin(static_cast<uint32_t>(timing.miningTimeMin)),
+          miningRange(static_cast<uint32_t>(timing.miningTimeMax - timing.miningTimeMin + 1))
+    {
+        reset(seed);
+    }
+
+    void reset(uint64_t seed) { initialState(seed, state); }
+
+    int miningTime(int /*truckId*/, int /*cycle*/)
+    {
+        return static_cast<int>(miningTimeMin + scale(next(), miningRange));
+    }
+
+    // The four state words for a seed (SplitMix64 of the seed, never all zero)
+    static void initialState(uint64_t seed, uint32_t (&words)[4])
+    {
+        uint64_t x = seed;
+        for (int i = 0; i < 4; i += 2)
+        {
+            x += 0x9E3779B97F4A7C15ull;
+            uint64_t z = x;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            z ^= z >> 31;
+            words[i] = static_cast<uint32_t>(z);
+            words[i + 1] = static_cast<uint32_t>(z >> 32);
+        }
+        if ((words[0] | words[1] | words[2] | words[3]) == 0)
+        {
+            words[0] = 1;
+        }
+    }
+
+    // Maps 32 random bits onto [0, range)
+    static uint32_t scale(uint32_t bits, uint32_t range)
+    {
+        return static_cast<uint32_t>((static_cast<uint64_t>(bits) * range) >> 32);
+    }
+
+    // One step of a generator in every lane: returns the outputs and advances
+    // the state words in place
+    static simd::LaneInts next(simd::LaneInts (&lanes)[4])
+    {
+        simd::LaneInts product = lanes[1] * simd::broadcast(5);
+        simd::LaneInts result = ((product << 7) | (product >> 25)) * simd::broadcast(9);
+        simd::LaneInts t = lanes[1] << 9;
+        lanes[2] = lanes[2] ^ lanes[0];
+        lanes[3] = lanes[3] ^ lanes[1];
+        lanes[1] = lanes[1] ^ lanes[2];
+        lanes[0] = lanes[0] ^ lanes[3];
+        lanes[2] = lanes[2] ^ t;
+        lanes[3] = (lanes[3] << 11) | (lanes[3] >> 21);
+        return result;
+    }
+
+private:
+    uint32_t miningTimeMin;
+    uint32_t miningRange;
+    uint32_t state[4];
+
+    static uint32_t rotl(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+
+    uint32_t next()
+    {
+        uint32_t result = rotl(state[1] * 5, 7) * 9;
+        uint32_t t = state[1] << 9;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 11);
+        return result;
+    }
+};
+
+/*
+ * ================================
+ * CLASS: BufferedXoshiroRng
+ * ================================
+ * RNG policy for hot loops: a ring of BUFFER_SIZE mining times, refilled in
+ * bulk, so a draw is a load and an index bump. The refill runs LANES (16)
+ * xoshiro128** generators side by side (lane l is Xoshiro128Rng seeded with
+ * l * 2^32 + seed) and maps each output with the same multiply-shift as
+ * Xoshiro128Rng. Draw i comes from lane i % LANES, so the stream differs from
+ * Xoshiro128Rng but is the same on every build: AVX-512 steps all 16 lanes in
+ * one vector, AVX2 and scalar builds in GROUPS vectors of simd::LANE_COUNT.
+ */
+class BufferedXoshiroRng
+{
+public:
+    static const int BUFFER_SIZE = 1024;
+    static const int LANES = 16;
+    static const int GROUPS = LANES / simd::LANE_COUNT;
+    static_assert(LANES % simd::LANE_COUNT == 0 && BUFFER_SIZE % LANES == 0, "lanes must tile the buffer");
+
+    explicit BufferedXoshiroRng(unsigned seed, const SiteTiming &timing = SiteTiming())
+        : miningTimeMin(timing.miningTimeMin), miningRange(timing.miningTimeMax - timing.miningTimeMin + 1),
+          buffer(BUFFER_SIZE), state(4 * LANES)
+    {
+        reset(seed);
+    }
+
+    void reset(unsigned seed)
+    {
+        for (int lane = 0; lane < LANES; ++lane)
+        {
+            uint32_t words[4];
+            Xoshiro128Rng::initialState(static_cast<uint64_t>(lane) << 32 | seed, words);
+            for (int word = 0; word < 4; ++word)
+            {
+                state[word * LANES + lane] = static_cast<int32_t>(words[word]);
+            }
+        }
+        position = BUFFER_SIZE; // refilled on the first draw
+    }
+
+    int miningTime(int /*truckId*/, int /*cycle*/)
+    {
+        if (position == BUFFER_SIZE)
+        {
+            refill();
+        }
+        return buffer[position++];
+    }
+
+private:
+    int miningTimeMin;
+    int miningRange;
+    int position; // next unread entry of buffer
+    std::vector<int32_t, AlignedAllocator<int32_t, 64>> buffer;
+    std::vector<int32_t, AlignedAllocator<int32_t, 64>> state; // [word * LANES + lane]
+
+    void refill()
+    {
+        // Group g holds lanes g * simd::LANE_COUNT onwards
+        simd::LaneInts lanes[GROUPS][4];
+        for (int group = 0; group < GROUPS; ++group)
+        {
+            for (int word = 0; word < 4; ++word)
+            {
+                lanes[group][word] = simd::loadLanes(&state[word * LANES + group * simd::LANE_COUNT]);
+            }
+        }
+        const simd::LaneInts first = simd::broadcast(miningTimeMin);
+        const simd::LaneInts range = simd::broadcast(miningRange);
+        for (int i = 0; i < BUFFER_SIZE; i += LANES)
+        {
+            for (int group = 0; group < GROUPS; ++group)
+            {
+                simd::storeLanes(&buffer[i + group * simd::LANE_COUNT],
+                                 first + simd::mulHigh(Xoshiro128Rng::next(lanes[group]), range));
+            }
+        }
+        for (int group = 0; group < GROUPS; ++group)
+        {
+            for (int word = 0; word < 4; ++word)
+            {
+                simd::storeLanes(&state[word * LANES + group * simd::LANE_COUNT], lanes[group][word]);
+            }
+        }
+        position = 0;
+    }
+};
+
+/*
+ * ================================
+ * CLASS: PhiloxRng
+ * ================================
+ * Counter-based RNG policy: the mining time for cycle c of truck t is
+ * Philox4x32-10 of the counter (t, c, 0, 0) under the key (seed, replication),
+ * mapped onto the mining range like Xoshiro128Rng. There is no stream state,
+ * so a truck draws the same durations whatever order events are handled in:
+ * the engines, queues, batch modes and thread counts that agree on when each
+ * truck finishes unloading agree on every mining time. A ReplicationRunner
+ * already gives replication r its own seed; the replication word is for
+ * callers that keep one seed across replications.
+ */
+class PhiloxRng
+{
+public:
+    explicit PhiloxRng(unsigned seed, const SiteTiming &timing = SiteTiming(), uint32_t _replication = 0)
+        : miningTimeMin(static_cast<uint32_t>(timing.miningTimeMin)),
+          miningRange(static_cast<uint32_t>(timing.miningTimeMax - timing.miningTimeMin + 1)), key{seed, _replication}
+    {
+    }
+
+    void reset(unsigned seed) { key[0] = seed; }
+
+    int miningTime(int truckId, int cycle)
+    {
+        uint32_t counter[4] = {static_cast<uint32_t>(truckId), static_cast<uint32_t>(cycle), 0, 0};
+        uint32_t bits[4];
+        block(counter, key, bits);
+        return static_cast<int>(miningTimeMin + Xoshiro128Rng::scale(bits[0], miningRange));
+    }
+
+    // Philox4x32-10 of one counter block
+    static void block(const uint32_t (&counter)[4], const uint32_t (&key)[2], uint32_t (&out)[4])
+    {
+        uint32_t x0 = counter[0], x1 = counter[1], x2 = counter[2], x3 = counter[3];
+        uint32_t k0 = key[0], k1 = key[1];
+        for (int round = 0; round < 10; ++round)
+        {
+            uint64_t product0 = static_cast<uint64_t>(0xD2511F53u) * x0;
+            uint64_t product1 = static_cast<uint64_t>(0xCD9E8D57u) * x2;
+            uint32_t y0 = static_cast<uint32_t>(product1 >> 32) ^ x1 ^ k0;
+            uint32_t y2 = static_cast<uint32_t>(product0 >> 32) ^ x3 ^ k1;
+            x0 = y0;
+            x1 = static_cast<uint32_t>(product1);
+            x2 = y2;
+            x3 = static_cast<uint32_t>(product0);
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        out[0] = x0;
+        out[1] = x1;
+        out[2] = x2;
+        out[3] = x3;
+    }
+
+private:
+    uint32_t miningTimeMin;
+    uint32_t miningRange;
+    uint32_t key[2];
+};
+
+// RNG policies whose draws depend only on (seed, truck, cycle), so every LP of
+// a parallel engine can share the run's seed
+template <typename Rng>
+struct IsCounterBasedRng : std::false_type
+{
+};
+
+template <>
+struct IsCounterBasedRng<PhiloxRng> : std::true_type
+{
+};
+
+/*
+ * ================================
+ * STRUCT: SimulationOptions
+ * ================================
+ * Engine modes that change how the simulation is executed, not what it models.
+ * Unless noted otherwise, every mode produces the same statistics as the defaults.
+ */
+struct SimulationOptions
+{
+    // Skip FINISH_MINING: travel has no contention, so when a truck starts mining
+    // its next station arrival (mining + outbound travel) is already known and is
+    // scheduled directly.
+    bool fuseTruckCycle = false;
+
+    // Pop every event of a minute at once and handle them grouped by type:
+    // FINISH_MINING, then FINISH_UNLOADING, then ARRIVE_STATION. Within the
+    // minute, arriving trucks therefore always see stations freed that same
+    // minute, so statistics can differ from the default (time, truck ID) order.
+    bool batchSameTime = false;
+
+    // Compact the event queue once more than this fraction of its entries are
+    // cancelled events waiting to be discarded
+    double maxStaleFraction = 0.5;
+};
+
+/*
+ * ================================
+ * CLASS: StationHandlers
+ * ================================
+ * The station side of the truck cycle (ARRIVE_STATION, START_UNLOADING and
+ * FINISH_UNLOADING), written once for Simulation and for the logical
+ * processes of both parallel engines. Host derives from
+ * StationHandlers<Host, Tick> and has the members trucks, stations,
+ * stationSelection, currentTime and timing, plus:
+ *  - scheduleEvent(time, type, truckId): queue a follow-up event.
+ *  - scheduleFinishMining(truckId, finishTime): the truck is mining again
+ *    until finishTime (what happens next is up to the engine).
+ * Before a handler overwrites a truck's or a station's state it calls
+ * saveTruck(truckId) or saveStation(station), and after changing a station it
+ * calls updateSelection(station); the next mining duration comes from
+ * nextMiningTime(truckId). The defaults below do no saving and draw from
+ * Host::rng with the truck's loads delivered as the cycle; a Host that can
+ * roll back (TimeWarpSimulation's LPs) hides them to fill its undo log.
+ */
+template <typename Host, typename Tick>
+class StationHandlers
+{
+protected:
+    /*
+     * A truck arrives at the station -> find the station with the shortest queue
+     * or an available station, and queue up.
+     */
+    void onArriveStation(int truckId)
+    {
+        Host &self = host();
+        BasicTruckTable<Tick> &trucks = self.trucks;
+
+        // If there are 0 stations, Truck waits forever
+        if (self.stations.size() <= 0)
+        {
+            self.saveTruck(truckId);
+            trucks.totalWaitTime[truckId] += static_cast<Tick>(self.timing.simulationTime - self.currentTime);
+            return;
+        }
+
+        // Find the station with the minimal queue time or an available station
+        int chosenStationId = self.stationSelection.select(self.stations, self.currentTime);
+        Station &station = self.stations[chosenStationId];
+        self.saveStation(station);
+        self.saveTruck(truckId);
+
+        // record time truck arrives at station
+        trucks.arrivalEventTime[truckId] = self.currentTime;
+
+        // Queue the truck at that station; if a bay is free it goes straight in.
+        // Queuing links the current last truck to this one.
+        trucks.stationId[truckId] = chosenStationId;
+        if (!station.truckQueue.empty())
+        {
+            self.saveTruck(station.truckQueue.back());
+        }
+        station.truckQueue.push(truckId, trucks.nextInQueue);
+        if (station.busyBays < station.bays)
+        {
+            startNextTruck(station);
+        }
+        self.updateSelection(station);
+    }
+
+    /*
+     * Hands a free bay to the front truck in the station's queue. The bay is
+     * claimed now rather than at START_UNLOADING so that a second truck arriving
+     * at the same minute sees it taken. The caller has saved the station.
+     */
+    void startNextTruck(Station &station)
+    {
+        Host &self = host();
+        int truckId = station.truckQueue.front();
+        self.saveTruck(truckId);
+        station.truckQueue.pop(self.trucks.nextInQueue);
+        station.claimBay(self.currentTime, station.unloadTime, self.timing.simulationTime);
+        self.scheduleEvent(self.currentTime, EventType::START_UNLOADING, truckId);
+    }
+
+    /*
+     * The truck starts unloading in the bay it was given.
+     */
+    void onStartUnloading(int truckId)
+    {
+        Host &self = host();
+        BasicTruckTable<Tick> &trucks = self.trucks;
+        self.saveTruck(truckId);
+
+        // Calculate how long the truck has been waiting
+        trucks.totalWaitTime[truckId] += static_cast<Tick>(self.currentTime - trucks.arrivalEventTime[truckId]);
+
+        // Truck starts unloading, schedule FINISH_UNLOADING
+        int unloadTime = self.stations[trucks.stationId[truckId]].unloadTime;
+        trucks.totalUnloadTime[truckId] += unloadTime;
+        double finishTime = self.currentTime + unloadTime;
+
+        self.scheduleEvent(finishTime, EventType::FINISH_UNLOADING, truckId);
+    }
+
+    /*
+     * The truck finishes unloading -> increment loads delivered; then travel back to mine site.
+     */
+    void onFinishUnloading(int truckId)
+    {
+        Host &self = host();
+        BasicTruckTable<Tick> &trucks = self.trucks;
+        Station &station = self.stations[trucks.stationId[truckId]];
+        self.saveStation(station);
+        self.saveTruck(truckId);
+        trucks.stationId[truckId] = -1;
+
+        // One load delivered
+        trucks.loadsDelivered[truckId]++;
+
+        // Free the bay; the next truck in queue can start unloading immediately
+        station.busyBays--;
+        if (!station.truckQueue.empty())
+        {
+            startNextTruck(station);
+        }
+        self.updateSelection(station);
+
+        // Truck travels back to site to mine again
+        trucks.totalTravelTime[truckId] += self.timing.travelTime;
+        double arrivalAtMineTime = self.currentTime + self.timing.travelTime;
+
+        // After traveling back, it starts mining again for random duration
+        int nextMiningTime = self.nextMiningTime(truckId);
+        trucks.totalMiningTime[truckId] += nextMiningTime;
+        self.scheduleFinishMining(truckId, arrivalAtMineTime + nextMiningTime);
+    }
+
+    // Undo-log hooks: nothing to save unless the Host can roll back
+    void saveTruck(int /*truckId*/) {}
+    void saveStation(const Station & /*station*/) {}
+
+    void updateSelection(const Station &station) { host().stationSelection.update(station, host().currentTime); }
+
+    int nextMiningTime(int truckId)
+    {
+        Host &self = host();
+        return self.rng.miningTime(truckId, self.trucks.loadsDelivered[truckId]);
+    }
+
+private:
+    Host &host() { return static_cast<Host &>(*this); }
+};
+
+/*
+ * ================================
+ * CLASS: Simulation
+ * ================================
+ * Manages the overall simulation, event queue, and data structures.
+ * The engines are compile-time policies, so each combination gets its own
+ * fully inlined event loop with no virtual calls:
+ *  - EventQueue: pending-event engine (IndexedEventHeap, RadixEventQueue,
+ *    LadderEventQueue, PackedEventHeap or BinaryHeapEventQueue); it must
+ *    provide empty(), top(), pop() and push(const Event &), which returns
+ *    true if it replaced an entry the truck already had.
+ *  - StationSelection: where an arriving truck queues (ShortestQueueSelection,
+ *    SimdShortestQueueSelection, ProjectedFreeTimeSelection or
+ *    PowerOfDChoicesSelection<D>).
+ *  - Rng: source of mining durations (MersenneTwisterRng, Xoshiro128Rng,
+ *    PhiloxRng or BufferedXoshiroRng).
+ *  - Tick: type of the per-truck time statistics (see BasicTruckTable). An
+ *    integer Tick assumes whole-minute times, which holds unless delayTruck()
+ *    is given a fractional delay.
+ * Simulation<> uses the original engines, but same-time events are handled
+ * in truck ID order, a bay is claimed when a truck is given it, START_UNLOADING
+ * is queued once, and busy time is clipped at the end of the run.
+ */
+template <typename EventQueue = IndexedEventHeap,
+          typename StationSelection = ShortestQueueSelection,
+          typename Rng = MersenneTwisterRng,
+          typename Tick = double>
+class Simulation : public StationHandlers<Simulation<EventQueue, StationSelection, Rng, Tick>, Tick>
+{
+private:
+    using Handlers = StationHandlers<Simulation, Tick>;
+    friend Handlers;
+    using Handlers::onArriveStation;
+    using Handlers::onStartUnloading;
+    using Handlers::onFinishUnloading;
+
+    // Pending events, earliest event first
+    EventQueue eventQueue;
+
+    // Chooses the station for each arriving truck
+    StationSelection stationSelection;
+
+    // The trucks and stations
+    BasicTruckTable<Tick> trucks;
+    std::vector<Station> stations;
+
+    // Random source for mining durations
+    Rng rng;
+
+    // Current time in simulation
+    double currentTime;
+
+    // Events due at currentTime, handled in order before consulting eventQueue
+    std::vector<Event> immediateEvents;
+    size_t immediateHead;
+
+    // Cancellation state: the current generation of each truck, the event it has
+    // in eventQueue (if any), and how many stale entries the queue still holds
+    std::vector<uint16_t> truckGeneration;
+    std::vector<Event> queuedEvents;
+    std::vector<uint8_t> hasQueuedEvent;
+    size_t staleEvents;
+    uint64_t compactions;
+
+    // Events of the current minute grouped by EventType (batchSameTime only)
+    std::vector<Event> batch[4];
+
+    // Number of events handled so far (for benchmarks)
+    uint64_t eventsProcessed;
+
+    SimulationOptions options;
+
+    // Durations of the truck cycle
+    SiteTiming timing;
+
+public:
+    Simulation(int numTrucks, int numStations, unsigned seed = std::random_device{}(),
+               SimulationOptions _options = SimulationOptions(), SiteTiming _timing = SiteTiming())
+        : Simulation(numTrucks, std::vector<int>(numStations, 1), seed, _options, _timing)
+    {
+    }
+
+    /*
+     * One station per entry of stationBays, each with that many unload bays.
+     */
+    Simulation(int numTrucks, const std::vector<int> &stationBays, unsigned seed = std::random_device{}(),
+               SimulationOptions _options = SimulationOptions(), SiteTiming _timing = SiteTiming())
+        : eventQueue(numTrucks), stationSelection(static_cast<int>(stationBays.size()), seed), trucks(numTrucks),
+          rng(seed, _timing), currentTime(0.0), immediateHead(0), truckGeneration(numTrucks), queuedEvents(numTrucks),
+          hasQueuedEvent(numTrucks), staleEvents(0), compactions(0), eventsProcessed(0), options(_options),
+          timing(_timing)
+    {
+        if (!timing.valid())
+        {
+            throw std::invalid_argument("site timing needs non-negative durations, miningTimeMin <= miningTimeMax and a positive cycle");
+        }
+        stations.reserve(stationBays.size());
+
+        // Initialize stations
+        size_t totalBays = 0;
+        for (size_t i = 0; i < stationBays.size(); ++i)
+        {
+            if (stationBays[i] < 1)
+            {
+                throw std::invalid_argument("every station needs at least one unload bay");
+            }
+            stations.push_back(Station(static_cast<int>(i), stationBays[i], timing.unloadTime));
+            totalBays += stationBays[i];
+        }
+        // At one instant each bay starts at most one unload
+        immediateEvents.reserve(totalBays);
+        for (const auto &station : stations)
+        {
+            stationSelection.update(station, currentTime);
+        }
+    }
+
+    /*
+     * Starts over at time 0 with a new seed, keeping the fleet, stations and
+     * options. All storage (event queue, station queues, scratch buffers) is
+     * reused, so once a run has grown every buffer, reset() + run() does not
+     * allocate. Statistics then match a new Simulation built with this seed.
+     */
+    void reset(unsigned seed)
+    {
+        eventQueue.clear();
+        stationSelection.reset(seed);
+        trucks.reset();
+        rng.reset(seed);
+        currentTime = 0.0;
+
+        immediateEvents.clear();
+        immediateHead = 0;
+        std::fill(truckGeneration.begin(), truckGeneration.end(), uint16_t(0));
+        std::fill(hasQueuedEvent.begin(), hasQueuedEvent.end(), uint8_t(0));
+        staleEvents = 0;
+        compactions = 0;
+        for (std::vector<Event> &group : batch)
+        {
+            group.clear();
+        }
+        eventsProcessed = 0;
+
+        for (auto &station : stations)
+        {
+            station.reset();
+        }
+        for (const auto &station : stations)
+        {
+            stationSelection.update(station, currentTime);
+        }
+    }
+
+    /*
+     * Runs the simulation up to timing.simulationTime minutes.
+     */
+    void run()
+    {
+        start();
+        advance(timing.simulationTime);
+    }
+
+    /*
+     * Schedules the first mining run of every truck. run() calls this; call it
+     * directly to drive the simulation in steps with advance().
+     */
+    void start()
+    {
+        // Schedule initial FINISH_MINING events for each truck
+        for (int truckId = 0; truckId < static_cast<int>(trucks.size()); ++truckId)
+        {
+            int miningTime = rng.miningTime(truckId, trucks.loadsDelivered[truckId]);
+            scheduleFinishMining(truckId, currentTime + miningTime);
+        }
+    }
+
+    /*
+     * Handles every event up to and including endTime.
+     */
+    void advance(double endTime)
+    {
+        while (true)
+        {
+            // Same-time follow-ups go first; the clock does not move for them
+            drainImmediateEvents();
+
+            // Stop once the next event is beyond our simulation window
+            Event evt;
+            if (!popNextEvent(endTime, evt))
+            {
+                break;
+            }
+
+            // Advance currentTime
+            currentTime = evt.time;
+
+            if (options.batchSameTime)
+            {
+                handleBatch(evt);
+                continue;
+            }
+
+            // Handle event
+            ++eventsProcessed;
+            handleEvent(evt);
+        }
+    }
+
+    /*
+     * Prints statistics for all trucks and stations.
+     */
+    void printStats()
+    {
+        std::cout << "\n==================== Simulation Statistics ====================\n";
+        // Print Truck Stats
+        for (const auto &truck : trucks)
+        {
+            truck.printStats();
+        }
+        // Print Station Stats (busy time was already clipped to the simulated window)
+        for (const auto &station : stations)
+        {
+            station.printStats();
+            double utilization = (station.totalBusyTime / (timing.simulationTime * station.bays)) * 100.0;
+            std::cout << "  Utilization: " << utilization << " %\n"
+                      << std::endl;
+        }
+
+        std::cout << "\n===============================================================\n\n\n";
+    }
+
+    /*
+     * Cancels the truck's queued event, e.g. for a recall or breakdown.
+     * The entry is not removed from the queue: bumping the truck's generation
+     * makes it stale, and it is discarded when popped (or by compaction).
+     * Returns false if the truck has no queued event (it is waiting in a
+     * station queue) or is unloading: its FINISH_UNLOADING holds a bay, whose
+     * busy time and the truck's unload time are already booked.
+     */
+    bool cancelTruckEvent(int truckId)
+    {
+        if (!hasQueuedEvent[truckId] || queuedEvents[truckId].type == EventType::FINISH_UNLOADING)
+        {
+            return false;
+        }
+        hasQueuedEvent[truckId] = 0;
+        ++truckGeneration[truckId];
+        ++staleEvents;
+        compactIfMostlyStale();
+        return true;
+    }
+
+    /*
+     * Pushes the truck's queued event back by delay minutes.
+     * Returns false if the truck has no queued event or is unloading (see
+     * cancelTruckEvent()).
+     */
+    bool delayTruck(int truckId, double delay)
+    {
+        Event evt = queuedEvents[truckId];
+        if (!cancelTruckEvent(truckId))
+        {
+            return false;
+        }
+        scheduleEvent(evt.time + delay, evt.type, truckId);
+        return true;
+    }
+
+    // Read-only access for tests and comparisons between engines
+    const BasicTruckTable<Tick> &getTrucks() const { return trucks; }
+    const std::vector<Station> &getStations() const { return stations; }
+    const SiteTiming &getTiming() const { return timing; }
+    uint64_t getEventsProcessed() const { return eventsProcessed; }
+    uint64_t getCompactions() const { return compactions; }
+
+private:
+    /*
+     * Schedule a new event by pushing it into the priority queue.
+     * Zero-delay follow-ups (START_UNLOADING at currentTime) skip the queue and
+     * run in FIFO order before the next queued event, which is exactly where
+     * the queue would have put them.
+     */
+    void scheduleEvent(double time, EventType type, int truckId)
+    {
+        Event evt{time, type, truckGeneration[truckId], truckId};
+        if (time <= currentTime)
+        {
+            immediateEvents.push_back(evt);
+            return;
+        }
+        queuedEvents[truckId] = evt;
+        hasQueuedEvent[truckId] = 1;
+        if (eventQueue.push(evt))
+        {
+            // The truck's cancelled entry was overwritten in place, so it will never pop
+            --staleEvents;
+        }
+    }
+
+    /*
+     * Pops the earliest live event at or before endTime into evt, discarding
+     * cancelled ones. Returns false if there is none.
+     */
+    bool popNextEvent(double endTime, Event &evt)
+    {
+        while (!eventQueue.empty())
+        {
+            evt = eventQueue.top();
+            if (evt.time > endTime)
+            {
+                return false;
+            }
+            eventQueue.pop();
+
+            if (isStale(evt))
+            {
+                --staleEvents;
+                continue;
+            }
+            hasQueuedEvent[evt.truckId] = 0;
+            return true;
+        }
+        return false;
+    }
+
+    // An event is stale once its truck's generation has moved on
+    bool isStale(const Event &evt) const
+    {
+        return evt.generation != truckGeneration[evt.truckId];
+    }
+
+    /*
+     * Rebuilds the event queue without cancelled entries once they make up more
+     * than options.maxStaleFraction of it, so heavy rescheduling cannot bloat it.
+     */
+    void compactIfMostlyStale()
+    {
+        const size_t MIN_STALE_TO_COMPACT = 64;
+        if (staleEvents < MIN_STALE_TO_COMPACT || staleEvents <= options.maxStaleFraction * eventQueue.size())
+        {
+            return;
+        }
+        eventQueue.compact([this](const Event &evt) { return isStale(evt); });
+        staleEvents = 0;
+        ++compactions;
+    }
+
+    /*
+     * Handle every event queued behind `first` at currentTime, grouped by type.
+     */
+    void handleBatch(const Event &first)
+    {
+        for (auto &group : batch)
+        {
+            group.clear();
+        }
+        batch[static_cast<int>(first.type)].push_back(first);
+        Event next;
+        while (popNextEvent(currentTime, next))
+        {
+            batch[static_cast<int>(next.type)].push_back(next);
+        }
+
+        // FINISH_MINING only touches its own truck, so the group is two flat loops
+        const std::vector<Event> &finishedMining = batch[static_cast<int>(EventType::FINISH_MINING)];
+        for (const Event &evt : finishedMining)
+        {
+            trucks.totalTravelTime[evt.truckId] += timing.travelTime;
+        }
+        for (const Event &evt : finishedMining)
+        {
+            scheduleEvent(currentTime + timing.travelTime, EventType::ARRIVE_STATION, evt.truckId);
+        }
+        eventsProcessed += finishedMining.size();
+
+        for (EventType type : {EventType::FINISH_UNLOADING, EventType::ARRIVE_STATION})
+        {
+            for (const Event &evt : batch[static_cast<int>(type)])
+            {
+                ++eventsProcessed;
+                handleEvent(evt);
+            }
+            drainImmediateEvents();
+        }
+    }
+
+    /*
+     * Handle the zero-delay events scheduled so far, in the order they were scheduled.
+     */
+    void drainImmediateEvents()
+    {
+        while (immediateHead < immediateEvents.size())
+        {
+            Event evt = immediateEvents[immediateHead++];
+            ++eventsProcessed;
+            handleEvent(evt);
+        }
+        immediateEvents.clear();
+        immediateHead = 0;
+    }
+
+    /*
+     * Handle the given event based on its type.
+     */
+    void handleEvent(const Event &evt)
+    {
+        switch (evt.type)
+        {
+        case EventType::FINISH_MINING:
+            onFinishMining(evt.truckId);
+            break;
+        case EventType::ARRIVE_STATION:
+            onArriveStation(evt.truckId);
+            break;
+        case EventType::START_UNLOADING:
+            onStartUnloading(evt.truckId);
+            break;
+        case EventType::FINISH_UNLOADING:
+            onFinishUnloading(evt.truckId);
+            break;
+        default:
+            break;
+        }
+    }
+
+    /*
+     * A truck finishes mining at the site -> travel to station
+     */
+    void onFinishMining(int truckId)
+    {
+        trucks.totalTravelTime[truckId] += timing.travelTime;
+        scheduleEvent(currentTime + timing.travelTime, EventType::ARRIVE_STATION, truckId);
+    }
+
+    /*
+     * The truck will finish mining at finishTime. Normally that is a FINISH_MINING
+     * event; with fuseTruckCycle the outbound trip is folded in and ARRIVE_STATION
+     * is scheduled directly.
+     */
+    void scheduleFinishMining(int truckId, double finishTime)
+    {
+        if (!options.fuseTruckCycle)
+        {
+            scheduleEvent(finishTime, EventType::FINISH_MINING, truckId);
+            return;
+        }
+
+        // Match onFinishMining, which never runs for a finish past the end of the run
+        if (finishTime <= timing.simulationTime)
+        {
+            trucks.totalTravelTime[truckId] += timing.travelTime;
+        }
+        scheduleEvent(finishTime + timing.travelTime, EventType::ARRIVE_STATION, truckId);
+    }
+};
+
+/*
+ * ================================
+ * STRUCT: SampleMoments
+ * ================================
+ * Running count, sum and sum of squares of one statistic over replications.
+ * Every statistic in the model is a whole number of minutes or loads, so while
+ * the sums stay below 2^53 they are exact: merging is order-independent and a
+ * summary comes out bit-identical however replications were spread over threads.
+ */
+struct SampleMoments
+{
+    uint64_t count = 0;
+    double sum = 0.0;
+    double sumSquares = 0.0;
+
+    void add(double x)
+    {
+        ++count;
+        sum += x;
+        sumSquares += x * x;
+    }
+
+    SampleMoments &operator+=(const SampleMoments &other)
+    {
+        count += other.count;
+        sum += other.sum;
+        sumSquares += other.sumSquares;
+        return *this;
+    }
+
+    double mean() const { return count > 0 ? sum / count : 0.0; }
+
+    // Sample variance (n - 1 denominator)
+    double variance() const
+    {
+        if (count < 2)
+        {
+            return 0.0;
+        }
+        double n = static_cast<double>(count);
+        return std::max(0.0, (sumSquares - sum * sum / n) / (n - 1.0));
+    }
+
+    // Half-width of the 95% confidence interval for the mean (Student t)
+    double halfWidth95() const
+    {
+        if (count < 2)
+        {
+            return 0.0;
+        }
+        return studentT975(count - 1) * std::sqrt(variance() / count);
+    }
+
+    // 97.5% quantile of Student's t with df degrees of freedom
+    static double studentT975(uint64_t df)
+    {
+        static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                       2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                       2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+        if (df <= 30)
+        {
+            return table[df - 1];
+        }
+        return 1.960 + 2.4 / df; // within 0.002 of the exact value past 30
+    }
+};
+
+/*
+ * ================================
+ * STRUCT: ReplicationSummary
+ * ================================
+ * Statistics of a scenario merged over independent replications: per truck,
+ * per station and fleet-wide, each as SampleMoments. The per-truck and
+ * per-station arrays are indexed by ID, like Simulation::getTrucks().
+ */
+struct ReplicationSummary
+{
+    // Per truck
+    std::vector<SampleMoments> loadsDelivered;
+    std::vector<SampleMoments> waitTime;
+    std::vector<SampleMoments> travelTime;
+    std::vector<SampleMoments> miningTime;
+    std::vector<SampleMoments> unloadTime;
+
+    // Per station: busy time summed over bays, and the bays it was divided by
+    std::vector<SampleMoments> stationBusyTime;
+    std::vector<int> stationBays;
+    int simulationTime = SIMULATION_TIME;
+
+    // Fleet totals of each replication
+    SampleMoments fleetLoads;
+    SampleMoments fleetWaitTime;
+
+    ReplicationSummary() {}
+
+    ReplicationSummary(int numTrucks, const std::vector<int> &_stationBays, int _simulationTime = SIMULATION_TIME)
+        : loadsDelivered(numTrucks), waitTime(numTrucks), travelTime(numTrucks), miningTime(numTrucks),
+          unloadTime(numTrucks), stationBusyTime(_stationBays.size()), stationBays(_stationBays),
+          simulationTime(_simulationTime)
+    {
+    }
+
+    // Mean utilization of a station over replications, in percent
+    double utilization(int stationId) const
+    {
+        return stationBusyTime[stationId].mean() * 100.0 / (simulationTime * stationBays[stationId]);
+    }
+
+    // Adds one finished replication
+    template <typename Sim>
+    void add(const Sim &sim)
+    {
+        const auto &trucks = sim.getTrucks();
+        for (size_t i = 0; i < trucks.size(); ++i)
+        {
+            loadsDelivered[i].add(trucks.loadsDelivered[i]);
+            waitTime[i].add(static_cast<double>(trucks.totalWaitTime[i]));
+            travelTime[i].add(static_cast<double>(trucks.totalTravelTime[i]));
+            miningTime[i].add(static_cast<double>(trucks.totalMiningTime[i]));
+            unloadTime[i].add(static_cast<double>(trucks.totalUnloadTime[i]));
+        }
+        for (const auto &station : sim.getStations())
+        {
+            stationBusyTime[station.id].add(station.totalBusyTime);
+        }
+        auto totals = trucks.totals();
+        fleetLoads.add(static_cast<double>(totals.loadsDelivered));
+        fleetWaitTime.add(static_cast<double>(totals.totalWaitTime));
+    }
+
+    ReplicationSummary &operator+=(const ReplicationSummary &other)
+    {
+        for (size_t i = 0; i < loadsDelivered.size(); ++i)
+        {
+            loadsDelivered[i] += other.loadsDelivered[i];
+            waitTime[i] += other.waitTime[i];
+            travelTime[i] += other.travelTime[i];
+            miningTime[i] += other.miningTime[i];
+            unloadTime[i] += other.unloadTime[i];
+        }
+        for (size_t i = 0; i < stationBusyTime.size(); ++i)
+        {
+            stationBusyTime[i] += other.stationBusyTime[i];
+        }
+        fleetLoads += other.fleetLoads;
+        fleetWaitTime += other.fleetWaitTime;
+        return *this;
+    }
+
+    uint64_t replications() const { return fleetLoads.count; }
+
+    /*
+     * Prints mean +/- 95% CI half-width for every truck and station, then the fleet.
+     */
+    void printStats() const
+    {
+        std::cout << "\n============ Replication Statistics (" << replications()
+                  << " replications, mean +/- 95% CI) ============\n";
+        for (size_t i = 0; i < loadsDelivered.size(); ++i)
+        {
+            std::cout << "Truck " << i << " Statistics:\n"
+                      << "  Loads Delivered: " << format(loadsDelivered[i]) << "\n"
+                      << "  Total Wait Time (min): " << format(waitTime[i]) << "\n"
+                      << "  Total Travel Time (min): " << format(travelTime[i]) << "\n"
+                      << "  Total Mining Time (min): " << format(miningTime[i]) << "\n"
+                      << "  Total Unload Time (min): " << format(unloadTime[i]) << "\n"
+                      << std::endl;
+        }
+        for (size_t i = 0; i < stationBusyTime.size(); ++i)
+        {
+            double scale = 100.0 / (simulationTime * stationBays[i]);
+            std::cout << "Station " << i << " Statistics:\n"
+                      << "  Total Busy Time (min): " << format(stationBusyTime[i]) << "\n"
+                      << "  Utilization: " << stationBusyTime[i].mean() * scale << " +/- "
+                      << stationBusyTime[i].halfWidth95() * scale << " %\n"
+                      << std::endl;
+        }
+        std::cout << "Fleet Statistics:\n"
+                  << "  Loads Delivered: " << format(fleetLoads) << "\n"
+                  << "  Total Wait Time (min): " << format(fleetWaitTime) << "\n"
+                  << "\n===============================================================\n\n\n";
+    }
+
+private:
+    static std::string format(const SampleMoments &moments)
+    {
+        return std::to_string(moments.mean()) + " +/- " + std::to_string(moments.halfWidth95());
+    }
+};
+
+/*
+ * Runs work(0), ..., work(numWorkers - 1) at once, worker 0 on the calling
+ * thread. A worker that throws does not stop the others; once every thread
+ * has been joined, the first exception caught is rethrown to the caller.
+ */
+template <typename Work>
+void runWorkers(unsigned numWorkers, const Work &work)
+{
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+    auto guarded = [&](unsigned worker) {
+        try
+        {
+            work(worker);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(failureMutex);
+            if (!failure)
+            {
+                failure = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(numWorkers - 1);
+    for (unsigned worker = 1; worker < numWorkers; ++worker)
+    {
+        threads.emplace_back(guarded, worker);
+    }
+    guarded(0);
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    if (failure)
+    {
+        std::rethrow_exception(failure);
+    }
+}
+
+/*
+ * ================================
+ * CLASS: ReplicationRunner
+ * ================================
+ * Runs independent replications of one scenario (fleet, stations, options) on
+ * a pool of worker threads. Replication r uses seed firstSeed + r, whichever
+ * worker runs it. Each worker builds one Sim on its first replication and
+ * reset()s it for the next, so runs after the first do not allocate, and keeps
+ * its own ReplicationSummary, so workers share nothing but the counter of the
+ * next replication to run. The summaries are added up at the end.
+ * Sims stay alive between run() calls and are reused by the next one.
+ */
+template <typename Sim>
+class ReplicationRunner
+{
+public:
+    ReplicationRunner(int _numTrucks, int numStations, SimulationOptions _options = SimulationOptions(),
+                      SiteTiming _timing = SiteTiming(), unsigned numThreads = 0)
+        : ReplicationRunner(_numTrucks, std::vector<int>(numStations, 1), _options, _timing, numThreads)
+    {
+    }
+
+    /*
+     * numThreads = 0 uses every hardware thread.
+     */
+    ReplicationRunner(int _numTrucks, const std::vector<int> &_stationBays,
+                      SimulationOptions _options = SimulationOptions(), SiteTiming _timing = SiteTiming(),
+                      unsigned numThreads = 0)
+        : numTrucks(_numTrucks), stationBays(_stationBays), options(_options), timing(_timing)
+    {
+        // Checked here rather than when a worker builds its Sim
+        if (numTrucks < 0)
+        {
+            throw std::invalid_argument("the fleet needs a non-negative number of trucks");
+        }
+        if (!timing.valid())
+        {
+            throw std::invalid_argument("site timing needs non-negative durations, miningTimeMin <= miningTimeMax and a positive cycle");
+        }
+        for (int bays : stationBays)
+        {
+            if (bays < 1)
+            {
+                throw std::invalid_argument("every station needs at least one unload bay");
+            }
+        }
+        if (numThreads == 0)
+        {
+            numThreads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        workerSims.resize(numThreads);
+    }
+
+    unsigned getNumThreads() const { return static_cast<unsigned>(workerSims.size()); }
+
+    /*
+     * Runs replications firstSeed, firstSeed + 1, ..., firstSeed + numReplications - 1
+     * and merges their statistics.
+     */
+    ReplicationSummary run(int numReplications, unsigned firstSeed)
+    {
+        std::atomic<int> nextReplication(0);
+        std::vector<ReplicationSummary> partial(workerSims.size());
+
+        auto work = [&](unsigned worker) {
+            std::unique_ptr<Sim> &sim = workerSims[worker];
+            ReplicationSummary local(numTrucks, stationBays, timing.simulationTime);
+            for (int r = nextReplication.fetch_add(1); r < numReplications; r = nextReplication.fetch_add(1))
+            {
+                unsigned seed = firstSeed + static_cast<unsigned>(r);
+                if (!sim)
+                {
+                    // Built on the worker's own thread, so its memory is local to it
+                    sim = std::make_unique<Sim>(numTrucks, stationBays, seed, options, timing);
+                }
+                else
+                {
+                    sim->reset(seed);
+                }
+                sim->run();
+                local.add(*sim);
+            }
+            partial[worker] = std::move(local);
+        };
+        runWorkers(getNumThreads(), work);
+
+        ReplicationSummary summary = partial[0];
+        for (size_t worker = 1; worker < partial.size(); ++worker)
+        {
+            summary += partial[worker];
+        }
+        return summary;
+    }
+
+private:
+    int numTrucks;
+    std::vector<int> stationBays;
+    SimulationOptions options;
+    SiteTiming timing;
+    std::vector<std::unique_ptr<Sim>> workerSims; // one per worker, created on first use
+};
+
+/*
+ * ================================
+ * CLASS: LockstepReplications
+ * ================================
+ * Runs LANES replications of one small scenario at once, one per SIMD lane.
+ * Every truck and station field is an array of [id][lane] int32s, so reading
+ * a field for all replications is one vector load. Each iteration handles the
+ * next event of every replication: the lanes pick their earliest (time, truck)
+ * with a vector argmin, and the ARRIVE_STATION and FINISH_UNLOADING handlers
+ * (with the zero-delay START_UNLOADING folded in) both run over all lanes,
+ * each writing only where its mask holds. A lane whose replication has ended
+ * just idles until the last one finishes.
+ *
+ * Lane l of runLanes(firstSeed) is exactly
+ * Simulation<IndexedEventHeap, ShortestQueueSelection, Xoshiro128Rng, int32_t>
+ * with seed firstSeed + l (the site side fused, which does not change the
+ * statistics); the mining draws are Xoshiro128Rng, vectorized over lanes.
+ * Each event costs O(trucks + stations) vector operations, which beats a heap
+ * only while the scenario is small: a handful of trucks and stations, run for
+ * very many replications. Per-bay busy times are not tracked.
+ */
+class LockstepReplications
+{
+public:
+    static const int LANES = simd::LANE_COUNT;
+
+    LockstepReplications(int _numTrucks, const std::vector<int> &_stationBays, SiteTiming _timing = SiteTiming())
+        : numTrucks(_numTrucks), numStations(static_cast<int>(_stationBays.size())), stationBays(_stationBays),
+          timing(_timing), nextTime(numTrucks * LANES), phase(numTrucks * LANES), stationOf(numTrucks * LANES),
+          arrivalTime(numTrucks * LANES), ticket(numTrucks * LANES), loadsDelivered(numTrucks * LANES),
+          totalWaitTime(numTrucks * LANES), totalTravelTime(numTrucks * LANES), totalMiningTime(numTrucks * LANES),
+          totalUnloadTime(numTrucks * LANES), queued(numStations * LANES), busyBays(numStations * LANES),
+          busyTime(numStations * LANES), rngState(4 * LANES)
+    {
+        if (numStations < 1)
+        {
+            throw std::invalid_argument("lockstep replications need at least one station");
+        }
+        if (!timing.valid())
+        {
+            throw std::invalid_argument("site timing needs non-negative durations, miningTimeMin <= miningTimeMax and a positive cycle");
+        }
+        for (int bays : stationBays)
+        {
+            if (bays < 1)
+            {
+                throw std::invalid_argument("every station needs at least one unload bay");
+            }
+        }
+    }
+
+    LockstepReplications(int _numTrucks, int _numStations, SiteTiming _timing = SiteTiming())
+        : LockstepReplications(_numTrucks, std::vector<int>(_numStations, 1), _timing)
+    {
+    }
+
+    /*
+     * Runs replications firstSeed, ..., firstSeed + LANES - 1, one per lane.
+     */
+    void runLanes(unsigned firstSeed)
+    {
+        start(firstSeed);
+
+        const LaneInts never = simd::broadcast(NEVER);
+        const LaneInts endTime = simd::broadcast(timing.simulationTime);
+        const LaneInts travelTime = simd::broadcast(timing.travelTime);
+        const LaneInts unloadTime = simd::broadcast(timing.unloadTime);
+        const LaneInts one = simd::broadcast(1);
+        const LaneInts zero = simd::broadcast(0);
+        LaneInts nextTicket = zero;
+
+        while (true)
+        {
+            // Each lane's next event: earliest time, lowest truck ID on ties
+            LaneInts now = never;
+            LaneInts truck = zero;
+            for (int t = 0; t < numTrucks; ++t)
+            {
+                LaneInts time = simd::loadLanes(&nextTime[t * LANES]);
+                LaneMask earlier = time < now;
+                now = simd::select(earlier, time, now);
+                truck = simd::select(earlier, simd::broadcast(t), truck);
+            }
+            LaneMask active = !(endTime < now);
+            if (!simd::any(active))
+            {
+                break;
+            }
+
+            // What that truck is doing, and where
+            LaneInts truckPhase = zero;
+            LaneInts truckStation = zero;
+            for (int t = 0; t < numTrucks; ++t)
+            {
+                LaneMask isTruck = truck == simd::broadcast(t);
+                truckPhase = simd::select(isTruck, simd::loadLanes(&phase[t * LANES]), truckPhase);
+                truckStation = simd::select(isTruck, simd::loadLanes(&stationOf[t * LANES]), truckStation);
+            }
+            LaneMask arriving = active & (truckPhase == simd::broadcast(ARRIVING));
+            LaneMask finishing = active & (truckPhase == simd::broadcast(UNLOADING));
+
+            // ARRIVE_STATION: the lowest backlog, lowest ID on ties (ShortestQueueSelection)
+            LaneInts chosen = zero;
+            LaneInts minBacklog = simd::broadcast(std::numeric_limits<int32_t>::max());
+            LaneMask chosenHasFreeBay = LaneMask();
+            for (int s = 0; s < numStations; ++s)
+            {
+                LaneInts busy = simd::loadLanes(&busyBays[s * LANES]);
+                LaneInts bays = simd::broadcast(stationBays[s]);
+                LaneInts backlog = simd::loadLanes(&queued[s * LANES]) + busy - bays;
+                LaneMask better = backlog < minBacklog;
+                minBacklog = simd::select(better, backlog, minBacklog);
+                chosen = simd::select(better, simd::broadcast(s), chosen);
+                chosenHasFreeBay = (better & (busy < bays)) | ((!better) & chosenHasFreeBay);
+            }
+            LaneMask startNow = arriving & chosenHasFreeBay;
+            LaneMask queueUp = arriving & !chosenHasFreeBay;
+            LaneInts station = simd::select(arriving, chosen, truckStation);
+
+            // Station side of both events; a finishing truck hands its bay to the
+            // front of the queue if there is one
+            LaneInts counted = simd::min(unloadTime, endTime - now); // busy time inside the run
+            LaneMask promote = LaneMask();
+            for (int s = 0; s < numStations; ++s)
+            {
+                LaneMask here = (arriving | finishing) & (station == simd::broadcast(s));
+                if (!simd::any(here))
+                {
+                    continue;
+                }
+                LaneInts waiting = simd::loadLanes(&queued[s * LANES]);
+                LaneMask handOver = here & finishing & (zero < waiting);
+                LaneMask claim = (here & startNow) | handOver;
+                LaneInts busy = simd::loadLanes(&busyBays[s * LANES]);
+                busy = simd::select(claim, busy + one, busy);
+                busy = simd::select(here & finishing, busy - one, busy);
+                waiting = simd::select(here & queueUp, waiting + one, waiting);
+                waiting = simd::select(handOver, waiting - one, waiting);
+                simd::storeLanes(&busyBays[s * LANES], busy);
+                simd::storeLanes(&queued[s * LANES], waiting);
+                LaneInts busyFor = simd::loadLanes(&busyTime[s * LANES]);
+                simd::storeLanes(&busyTime[s * LANES], simd::select(claim, busyFor + counted, busyFor));
+                promote = promote | handOver;
+            }
+
+            // Front of the queue: the waiting truck there with the lowest ticket
+            LaneInts front = never;
+            if (simd::any(promote))
+            {
+                LaneInts frontTicket = never;
+                for (int t = 0; t < numTrucks; ++t)
+                {
+                    LaneInts truckTicket = simd::loadLanes(&ticket[t * LANES]);
+                    LaneMask candidate = promote &
+                                         (simd::loadLanes(&phase[t * LANES]) == simd::broadcast(WAITING)) &
+                                         (simd::loadLanes(&stationOf[t * LANES]) == station) &
+                                         (truckTicket < frontTicket);
+                    frontTicket = simd::select(candidate, truckTicket, frontTicket);
+                    front = simd::select(candidate, simd::broadcast(t), front);
+                }
+            }
+
+            // A finishing truck drives back and mines again
+            LaneInts miningTime = drawMiningTime(finishing);
+            LaneInts finishMining = now + travelTime + miningTime;
+            LaneMask minedInTime = !(endTime < finishMining);
+
+            // Truck side: the event's own truck, and the one promoted from the queue
+            for (int t = 0; t < numTrucks; ++t)
+            {
+                LaneMask isTruck = truck == simd::broadcast(t);
+                LaneMask isFront = front == simd::broadcast(t);
+                LaneMask arrives = isTruck & arriving;
+                LaneMask finishes = isTruck & finishing;
+                LaneMask starts = (arrives & startNow) | isFront;
+                if (!simd::any(arrives | finishes | isFront))
+                {
+                    continue;
+                }
+                int row = t * LANES;
+
+                LaneInts arrived = simd::select(arrives, now, simd::loadLanes(&arrivalTime[row]));
+                simd::storeLanes(&arrivalTime[row], arrived);
+                simd::storeLanes(&stationOf[row], simd::select(arrives, station, simd::loadLanes(&stationOf[row])));
+                simd::storeLanes(&ticket[row],
+                                 simd::select(arrives & queueUp, nextTicket, simd::loadLanes(&ticket[row])));
+
+                LaneInts wait = simd::loadLanes(&totalWaitTime[row]);
+                simd::storeLanes(&totalWaitTime[row], simd::select(starts, wait + now - arrived, wait));
+                LaneInts unload = simd::loadLanes(&totalUnloadTime[row]);
+                simd::storeLanes(&totalUnloadTime[row], simd::select(starts, unload + unloadTime, unload));
+                LaneInts loads = simd::loadLanes(&loadsDelivered[row]);
+                simd::storeLanes(&loadsDelivered[row], simd::select(finishes, loads + one, loads));
+                LaneInts mining = simd::loadLanes(&totalMiningTime[row]);
+                simd::storeLanes(&totalMiningTime[row], simd::select(finishes, mining + miningTime, mining));
+                LaneInts travel = simd::loadLanes(&totalTravelTime[row]);
+                travel = simd::select(finishes, travel + travelTime, travel);
+                travel = simd::select(finishes & minedInTime, travel + travelTime, travel);
+                simd::storeLanes(&totalTravelTime[row], travel);
+
+                LaneInts next = simd::loadLanes(&nextTime[row]);
+                LaneInts truckPhaseNow = simd::loadLanes(&phase[row]);
+                next = simd::select(starts, now + unloadTime, next);
+                truckPhaseNow = simd::select(starts, simd::broadcast(UNLOADING), truckPhaseNow);
+                next = simd::select(arrives & queueUp, never, next);
+                truckPhaseNow = simd::select(arrives & queueUp, simd::broadcast(WAITING), truckPhaseNow);
+                next = simd::select(finishes, finishMining + travelTime, next);
+                truckPhaseNow = simd::select(finishes, simd::broadcast(ARRIVING), truckPhaseNow);
+                simd::storeLanes(&nextTime[row], next);
+                simd::storeLanes(&phase[row], truckPhaseNow);
+            }
+            nextTicket = simd::select(queueUp, nextTicket + one, nextTicket);
+        }
+    }
+
+    /*
+     * Runs numReplications replications (seeds firstSeed, firstSeed + 1, ...)
+     * LANES at a time and merges their statistics, like ReplicationRunner.
+     */
+    ReplicationSummary run(int numReplications, unsigned firstSeed)
+    {
+        ReplicationSummary summary(numTrucks, stationBays, timing.simulationTime);
+        for (int first = 0; first < numReplications; first += LANES)
+        {
+            runLanes(firstSeed + static_cast<unsigned>(first));
+            for (int lane = 0; lane < LANES && first + lane < numReplications; ++lane)
+            {
+                addLane(summary, lane);
+            }
+        }
+        return summary;
+    }
+
+    // Statistics of one lane of the last runLanes()
+    Truck getTruck(int lane, int truckId) const
+    {
+        int i = truckId * LANES + lane;
+        Truck truck(truckId);
+        truck.loadsDelivered = loadsDelivered[i];
+        truck.totalWaitTime = totalWaitTime[i];
+        truck.totalTravelTime = totalTravelTime[i];
+        truck.totalMiningTime = totalMiningTime[i];
+        truck.totalUnloadTime = totalUnloadTime[i];
+        return truck;
+    }
+
+    int getStationBusyTime(int lane, int stationId) const { return busyTime[stationId * LANES + lane]; }
+
+private:
+    using LaneInts = simd::LaneInts;
+    using LaneMask = simd::LaneMask;
+
+    // What a truck's pending event is
+    static const int32_t ARRIVING = 0;  // ARRIVE_STATION at nextTime
+    static const int32_t UNLOADING = 1; // FINISH_UNLOADING at nextTime
+    static const int32_t WAITING = 2;   // queued, no event
+    static const int32_t NEVER = std::numeric_limits<int32_t>::max();
+
+    using LaneArray = std::vector<int32_t, AlignedAllocator<int32_t, 64>>;
+
+    int numTrucks;
+    int numStations;
+    std::vector<int> stationBays;
+    SiteTiming timing;
+
+    // Per truck, [truckId * LANES + lane]
+    LaneArray nextTime;
+    LaneArray phase;
+    LaneArray stationOf;
+    LaneArray arrivalTime;
+    LaneArray ticket; // arrival order, for FIFO queues
+    LaneArray loadsDelivered;
+    LaneArray totalWaitTime;
+    LaneArray totalTravelTime;
+    LaneArray totalMiningTime;
+    LaneArray totalUnloadTime;
+
+    // Per station, [stationId * LANES + lane]
+    LaneArray queued;
+    LaneArray busyBays;
+    LaneArray busyTime;
+
+    // Xoshiro128Rng state, [word * LANES + lane]
+    LaneArray rngState;
+
+    /*
+     * Clears every lane, seeds it, and starts every truck mining (in truck
+     * order, like Simulation::start()).
+     */
+    void start(unsigned firstSeed)
+    {
+        for (LaneArray *field : {&phase, &stationOf, &arrivalTime, &ticket, &loadsDelivered, &totalWaitTime,
+                                 &totalTravelTime, &totalMiningTime, &totalUnloadTime, &queued, &busyBays, &busyTime})
+        {
+            std::fill(field->begin(), field->end(), 0);
+        }
+        for (int lane = 0; lane < LANES; ++lane)
+        {
+            uint32_t words[4];
+            Xoshiro128Rng::initialState(firstSeed + static_cast<unsigned>(lane), words);
+            for (int word = 0; word < 4; ++word)
+            {
+                rngState[word * LANES + lane] = static_cast<int32_t>(words[word]);
+            }
+        }
+
+        const LaneInts endTime = simd::broadcast(timing.simulationTime);
+        const LaneInts travelTime = simd::broadcast(timing.travelTime);
+        LaneMask allLanes = simd::broadcast(0) == simd::broadcast(0);
+        for (int t = 0; t < numTrucks; ++t)
+        {
+            int row = t * LANES;
+            LaneInts finishMining = drawMiningTime(allLanes);
+            LaneMask minedInTime = !(endTime < finishMining);
+            simd::storeLanes(&totalTravelTime[row], simd::select(minedInTime, travelTime, simd::broadcast(0)));
+            simd::storeLanes(&nextTime[row], finishMining + travelTime);
+        }
+    }
+
+    // One Xoshiro128Rng draw in the lanes of draw; other lanes keep their state
+    LaneInts drawMiningTime(LaneMask draw)
+    {
+        LaneInts lanes[4];
+        for (int word = 0; word < 4; ++word)
+        {
+            lanes[word] = simd::loadLanes(&rngState[word * LANES]);
+        }
+        LaneInts before[4] = {lanes[0], lanes[1], lanes[2], lanes[3]};
+        LaneInts bits = Xoshiro128Rng::next(lanes);
+        for (int word = 0; word < 4; ++word)
+        {
+            simd::storeLanes(&rngState[word * LANES], simd::select(draw, lanes[word], before[word]));
+        }
+
+        LaneInts range = simd::broadcast(timing.miningTimeMax - timing.miningTimeMin + 1);
+        return simd::broadcast(timing.miningTimeMin) + simd::mulHigh(bits, range);
+    }
+
+    void addLane(ReplicationSummary &summary, int lane) const
+    {
+        int64_t fleetLoads = 0;
+        int64_t fleetWait = 0;
+        for (int t = 0; t < numTrucks; ++t)
+        {
+            int i = t * LANES + lane;
+            summary.loadsDelivered[t].add(loadsDelivered[i]);
+            summary.waitTime[t].add(totalWaitTime[i]);
+            summary.travelTime[t].add(totalTravelTime[i]);
+            summary.miningTime[t].add(totalMiningTime[i]);
+            summary.unloadTime[t].add(totalUnloadTime[i]);
+            fleetLoads += loadsDelivered[i];
+            fleetWait += totalWaitTime[i];
+        }
+        for (int s = 0; s < numStations; ++s)
+        {
+            summary.stationBusyTime[s].add(busyTime[s * LANES + lane]);
+        }
+        summary.fleetLoads.add(static_cast<double>(fleetLoads));
+        summary.fleetWaitTime.add(static_cast<double>(fleetWait));
+    }
+};
+
+/*
+ * ================================
+ * STRUCT: SweepPoint
+ * ================================
+ * One scenario of a parameter sweep.
+ */
+struct SweepPoint
+{
+    int numTrucks;
+    int numStations;
+    SiteTiming timing;
+
+    bool valid() const { return numTrucks >= 0 && numStations >= 0 && timing.valid(); }
+
+    // Rough cost of one replication, used only to order work: the expected
+    // number of events (four per truck cycle) times the log of the fleet size,
+    // which bounds the event-queue work per event
+    double expectedCost() const
+    {
+        double mining = (timing.miningTimeMin + timing.miningTimeMax) / 2.0;
+        double cycle = mining + 2.0 * timing.travelTime + timing.unloadTime;
+        double events = 4.0 * numTrucks * timing.simulationTime / std::max(cycle, 1.0);
+        return events * std::log2(numTrucks + 2.0) + numStations;
+    }
+};
+
+/*
+ * ================================
+ * STRUCT: SweepResult
+ * ================================
+ * Statistics of one sweep point over its replications.
+ */
+struct SweepResult
+{
+    SweepPoint point;
+    SampleMoments utilization;    // mean station utilization of a run (%)
+    SampleMoments waitPerLoad;    // fleet wait time / loads delivered of a run (min)
+    SampleMoments loadsDelivered; // fleet loads delivered of a run
+
+    static void printHeader()
+    {
+        std::cout << std::setw(9) << "trucks" << std::setw(9) << "stations" << std::setw(9) << "mining"
+                  << std::setw(8) << "travel" << std::setw(8) << "unload" << std::setw(20) << "utilization %"
+                  << std::setw(20) << "wait/load (min)" << std::setw(22) << "loads delivered" << "\n";
+    }
+
+    // One row: mean +/- 95% CI half-width of each statistic
+    void printRow() const
+    {
+        std::string mining =
+            std::to_string(point.timing.miningTimeMin) + "-" + std::to_string(point.timing.miningTimeMax);
+        std::cout << std::setw(9) << point.numTrucks << std::setw(9) << point.numStations << std::setw(9) << mining
+                  << std::setw(8) << point.timing.travelTime << std::setw(8) << point.timing.unloadTime << std::fixed
+                  << std::setprecision(2) << std::setw(10) << utilization.mean() << " +/- " << std::setw(5)
+                  << utilization.halfWidth95() << std::setw(10) << waitPerLoad.mean() << " +/- " << std::setw(5)
+                  << waitPerLoad.halfWidth95() << std::setw(11) << std::setprecision(1) << loadsDelivered.mean()
+                  << " +/- " << std::setw(6) << loadsDelivered.halfWidth95() << "\n";
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+};
+
+/*
+ * ================================
+ * CLASS: SweepEngine
+ * ================================
+ * Runs replications of every point of a parameter grid on a work-stealing
+ * pool. Run costs differ by orders of magnitude across a grid, so the
+ * (point, replication) tasks are sorted by SweepPoint::expectedCost(),
+ * longest first, and each worker is dealt a contiguous run of them in its own
+ * deque, so it mostly runs replications of one point back to back. A worker
+ * takes tasks from the front of its own deque; once it is empty, it steals
+ * the front of whichever deque holds the longest task left, so expensive
+ * points never sit queued behind a busy worker while others idle.
+ * Replication r of every point uses seed firstSeed + r. A worker reuses its
+ * Sim (via reset()) while consecutive tasks belong to the same point.
+ */
+template <typename Sim>
+class SweepEngine
+{
+public:
+    /*
+     * numThreads = 0 uses every hardware thread.
+     */
+    explicit SweepEngine(SimulationOptions _options = SimulationOptions(), unsigned _numThreads = 0)
+        : options(_options), numThreads(_numThreads)
+    {
+        if (numThreads == 0)
+        {
+            numThreads = std::max(1u, std::thread::hardware_concurrency());
+        }
+    }
+
+    // Every combination of the given truck counts, station counts and timings
+    static std::vector<SweepPoint> grid(const std::vector<int> &truckCounts, const std::vector<int> &stationCounts,
+                                        const std::vector<SiteTiming> &timings = std::vector<SiteTiming>(1))
+    {
+        std::vector<SweepPoint> points;
+        points.reserve(truckCounts.size() * stationCounts.size() * timings.size());
+        for (int numTrucks : truckCounts)
+        {
+            for (int numStations : stationCounts)
+            {
+                for (const SiteTiming &timing : timings)
+                {
+                    points.push_back(SweepPoint{numTrucks, numStations, timing});
+                }
+            }
+        }
+        return points;
+    }
+
+    /*
+     * Runs `replications` replications of every point and returns the results
+     * in the order of `points`. As soon as the last replication of a point
+     * finishes, onPointDone (if set) is called with its result from the worker
+     * that finished it; calls never overlap.
+     */
+    std::vector<SweepResult> run(const std::vector<SweepPoint> &points, int replications, unsigned firstSeed,
+                                 const std::function<void(const SweepResult &)> &onPointDone = nullptr)
+    {
+        // Refused here rather than when a worker builds its Sim
+        for (const SweepPoint &point : points)
+        {
+            if (!point.valid())
+            {
+                throw std::invalid_argument("every sweep point needs non-negative trucks and stations and valid timing");
+            }
+        }
+        std::vector<SweepResult> results(points.size());
+        if (points.empty() || replications <= 0)
+        {
+            return results;
+        }
+
+        // Longest expected first; replications of a point stay next to each other
+        std::vector<double> cost(points.size());
+        for (size_t point = 0; point < points.size(); ++point)
+        {
+            cost[point] = points[point].expectedCost();
+        }
+        std::vector<Task> tasks;
+        tasks.reserve(points.size() * replications);
+        for (size_t point = 0; point < points.size(); ++point)
+        {
+            for (int r = 0; r < replications; ++r)
+            {
+                tasks.push_back(Task{static_cast<int>(point), r, cost[point]});
+            }
+        }
+        std::stable_sort(tasks.begin(), tasks.end(), [&](const Task &a, const Task &b) {
+            return cost[a.point] > cost[b.point];
+        });
+
+        // Worker w gets tasks [w * n / numThreads, (w + 1) * n / numThreads)
+        std::vector<WorkerQueue> queues(numThreads);
+        for (unsigned worker = 0; worker < numThreads; ++worker)
+        {
+            size_t first = tasks.size() * worker / numThreads;
+            size_t last = tasks.size() * (worker + 1) / numThreads;
+            queues[worker].tasks.assign(tasks.begin() + first, tasks.begin() + last);
+        }
+
+        // Each replication writes its own slot, and the worker finishing a point
+        // merges that point's slots in replication order
+        std::vector<Sample> samples(points.size() * replications);
+        std::vector<std::atomic<int>> remaining(points.size());
+        for (std::atomic<int> &count : remaining)
+        {
+            count.store(replications);
+        }
+        std::mutex reportMutex;
+
+        auto work = [&](unsigned worker) {
+            std::unique_ptr<Sim> sim;
+            int simPoint = -1;
+            Task task;
+            while (takeTask(queues, worker, task))
+            {
+                const SweepPoint &point = points[task.point];
+                unsigned seed = firstSeed + static_cast<unsigned>(task.replication);
+                if (task.point != simPoint)
+                {
+                    sim = std::make_unique<Sim>(point.numTrucks, point.numStations, seed, options, point.timing);
+                    simPoint = task.point;
+                }
+                else
+                {
+                    sim->reset(seed);
+                }
+                sim->run();
+                samples[task.point * replications + task.replication] = measure(*sim);
+
+                if (remaining[task.point].fetch_sub(1) == 1)
+                {
+                    SweepResult &result = results[task.point];
+                    result.point = point;
+                    for (int r = 0; r < replications; ++r)
+                    {
+                        const Sample &sample = samples[task.point * replications + r];
+                        result.utilization.add(sample.utilization);
+                        result.waitPerLoad.add(sample.waitPerLoad);
+                        result.loadsDelivered.add(sample.loadsDelivered);
+                    }
+                    if (onPointDone)
+                    {
+                        std::lock_guard<std::mutex> lock(reportMutex);
+                        onPointDone(result);
+                    }
+                }
+            }
+        };
+        runWorkers(numThreads, work);
+        return results;
+    }
+
+    // What one replication contributes to its point's SweepResult
+    struct Sample
+    {
+        double utilization;
+        double waitPerLoad;
+        double loadsDelivered;
+    };
+
+    static Sample measure(const Sim &sim)
+    {
+        const SiteTiming &timing = sim.getTiming();
+        double utilization = 0.0;
+        for (const Station &station : sim.getStations())
+        {
+            utilization += station.totalBusyTime / (static_cast<double>(timing.simulationTime) * station.bays);
+        }
+        if (!sim.getStations().empty() && timing.simulationTime > 0)
+        {
+            utilization = utilization * 100.0 / sim.getStations().size();
+        }
+
+        auto totals = sim.getTrucks().totals();
+        double loads = static_cast<double>(totals.loadsDelivered);
+        double waitPerLoad = loads > 0 ? static_cast<double>(totals.totalWaitTime) / loads : 0.0;
+        return Sample{utilization, waitPerLoad, loads};
+    }
+
+private:
+    struct Task
+    {
+        int point;
+        int replication;
+        double cost;
+    };
+
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    SimulationOptions options;
+    unsigned numThreads;
+
+    // The worker's own next task, else the longest one it can steal. Deques are
+    // sorted longest first, so the longest task left is the costliest front.
+    bool takeTask(std::vector<WorkerQueue> &queues, unsigned worker, Task &task)
+    {
+        if (popFront(queues[worker], task))
+        {
+            return true;
+        }
+        while (true)
+        {
+            int victim = -1;
+            double victimCost = 0.0;
+            for (unsigned i = 0; i < numThreads; ++i)
+            {
+                std::lock_guard<std::mutex> lock(queues[i].mutex);
+                if (!queues[i].tasks.empty() && (victim < 0 || queues[i].tasks.front().cost > victimCost))
+                {
+                    victim = static_cast<int>(i);
+                    victimCost = queues[i].tasks.front().cost;
+                }
+            }
+            if (victim < 0)
+            {
+                return false;
+            }
+            // Another thief may have emptied it meanwhile; then look again
+            if (popFront(queues[victim], task))
+            {
+                return true;
+            }
+        }
+    }
+
+    static bool popFront(WorkerQueue &queue, Task &task)
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+        {
+            return false;
+        }
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+        return true;
+    }
+};
+
+/*
+ * ================================
+ * STRUCT: PairedStatistic
+ * ================================
+ * One statistic of a paired comparison: its replications under the baseline
+ * and the alternative, and the per-replication differences (alternative
+ * minus baseline). The runs of a pair share their random numbers, so the
+ * differences vary far less than either side and the CI of the difference is
+ * much narrower than the one from independent runs.
+ */
+struct PairedStatistic
+{
+    SampleMoments baseline;
+    SampleMoments alternative;
+    SampleMoments difference;
+
+    void add(double baselineValue, double alternativeValue)
+    {
+        baseline.add(baselineValue);
+        alternative.add(alternativeValue);
+        difference.add(alternativeValue - baselineValue);
+    }
+
+    // Half-width of the 95% CI of the difference had both sides been run with
+    // independent random numbers (same variances, same replication count)
+    double unpairedHalfWidth95() const
+    {
+        if (difference.count < 2)
+        {
+            return 0.0;
+        }
+        return SampleMoments::studentT975(2 * difference.count - 2) *
+               std::sqrt((baseline.variance() + alternative.variance()) / difference.count);
+    }
+
+    // How many independent replications one paired replication is worth for
+    // estimating the difference: Var(A) + Var(B) over Var(B - A)
+    double varianceReduction() const
+    {
+        double pairedVariance = difference.variance();
+        double unpairedVariance = baseline.variance() + alternative.variance();
+        if (pairedVariance == 0.0)
+        {
+            return unpairedVariance == 0.0 ? 1.0 : std::numeric_limits<double>::infinity();
+        }
+        return unpairedVariance / pairedVariance;
+    }
+};
+
+/*
+ * ================================
+ * STRUCT: PairedComparisonResult
+ * ================================
+ * Outcome of PairedComparison::run().
+ */
+struct PairedComparisonResult
+{
+    SweepPoint baseline;
+    SweepPoint alternative;
+    PairedStatistic utilization;    // mean station utilization of a run (%)
+    PairedStatistic waitPerLoad;    // fleet wait time / loads delivered of a run (min)
+    PairedStatistic loadsDelivered; // fleet loads delivered of a run
+
+    uint64_t replications() const { return waitPerLoad.difference.count; }
+
+    /*
+     * Prints each statistic under both configurations, then the paired
+     * difference with its 95% CI, the CI independent runs would have given,
+     * and the variance reduction.
+     */
+    void printStats() const
+    {
+        std::cout << "\n============ Paired Comparison (" << replications() << " replications): "
+                  << baseline.numTrucks << " trucks / " << baseline.numStations << " stations vs "
+                  << alternative.numTrucks << " trucks / " << alternative.numStations << " stations ============\n";
+        std::cout << std::setw(18) << "statistic" << std::setw(20) << "baseline" << std::setw(20) << "alternative"
+                  << std::setw(22) << "difference" << std::setw(14) << "unpaired CI" << std::setw(12)
+                  << "reduction" << "\n";
+        printRow("utilization %", utilization);
+        printRow("wait/load (min)", waitPerLoad);
+        printRow("loads delivered", loadsDelivered);
+        std::cout << "===============================================================\n\n\n";
+    }
+
+private:
+    static void printRow(const char *name, const PairedStatistic &statistic)
+    {
+        std::cout << std::setw(18) << name << std::fixed << std::setprecision(2) << std::setw(10)
+                  << statistic.baseline.mean() << " +/- " << std::setw(5) << statistic.baseline.halfWidth95()
+                  << std::setw(10) << statistic.alternative.mean() << " +/- " << std::setw(5)
+                  << statistic.alternative.halfWidth95() << std::setw(12) << statistic.difference.mean() << " +/- "
+                  << std::setw(5) << statistic.difference.halfWidth95() << std::setw(9) << "+/- " << std::setw(5)
+                  << statistic.unpairedHalfWidth95() << std::setw(11) << statistic.varianceReduction() << "x\n";
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+};
+
+/*
+ * ================================
+ * CLASS: PairedComparison
+ * ================================
+ * Compares two configurations with common random numbers: replication r of
+ * both uses seed firstSeed + r, and with a counter-based Rng (PhiloxRng, the
+ * default here) truck i then mines for exactly the same durations, cycle by
+ * cycle, under either configuration, wherever its event order diverges. Only
+ * the capacity difference is left between the two runs of a pair, so the
+ * paired-difference CI needs far fewer replications than comparing two
+ * independent ReplicationRunner results. Replications are spread over a pool
+ * of threads like ReplicationRunner; each worker keeps one Sim per side and
+ * reset()s it. The samples are summed in replication order, so the result
+ * does not depend on the thread count.
+ */
+template <typename Sim = Simulation<IndexedEventHeap, ShortestQueueSelection, PhiloxRng>>
+class PairedComparison
+{
+public:
+    /*
+     * numThreads = 0 uses every hardware thread.
+     */
+    explicit PairedComparison(SimulationOptions _options = SimulationOptions(), unsigned _numThreads = 0)
+        : options(_options), numThreads(_numThreads)
+    {
+        if (numThreads == 0)
+        {
+            numThreads = std::max(1u, std::thread::hardware_concurrency());
+        }
+    }
+
+    /*
+     * Runs replications firstSeed, ..., firstSeed + replications - 1 of both
+     * configurations and pairs them up.
+     */
+    PairedComparisonResult run(const SweepPoint &baseline, const SweepPoint &alternative, int replications,
+                               unsigned firstSeed)
+    {
+        // Refused here rather than when a worker builds its Sim
+        if (!baseline.valid() || !alternative.valid())
+        {
+            throw std::invalid_argument("both configurations need non-negative trucks and stations and valid timing");
+        }
+        std::vector<Sample> baselineSamples(std::max(replications, 0));
+        std::vector<Sample> alternativeSamples(baselineSamples.size());
+        std::atomic<int> nextReplication(0);
+
+        auto work = [&](unsigned /*worker*/) {
+            std::unique_ptr<Sim> baselineSim;
+            std::unique_ptr<Sim> alternativeSim;
+            for (int r = nextReplication.fetch_add(1); r < replications; r = nextReplication.fetch_add(1))
+            {
+                unsigned seed = firstSeed + static_cast<unsigned>(r);
+                baselineSamples[r] = runOne(baselineSim, baseline, seed);
+                alternativeSamples[r] = runOne(alternativeSim, alternative, seed);
+            }
+        };
+        runWorkers(numThreads, work);
+
+        PairedComparisonResult result;
+        result.baseline = baseline;
+        result.alternative = alternative;
+        for (size_t r = 0; r < baselineSamples.size(); ++r)
+        {
+            const Sample &a = baselineSamples[r];
+            const Sample &b = alternativeSamples[r];
+            result.utilization.add(a.utilization, b.utilization);
+            result.waitPerLoad.add(a.waitPerLoad, b.waitPerLoad);
+            result.loadsDelivered.add(a.loadsDelivered, b.loadsDelivered);
+        }
+        return result;
+    }
+
+private:
+    using Sample = typename SweepEngine<Sim>::Sample;
+
+    SimulationOptions options;
+    unsigned numThreads;
+
+    Sample runOne(std::unique_ptr<Sim> &sim, const SweepPoint &point, unsigned seed)
+    {
+        if (!sim)
+        {
+            sim = std::make_unique<Sim>(point.numTrucks, point.numStations, seed, options, point.timing);
+        }
+        else
+        {
+            sim->reset(seed);
+        }
+        sim->run();
+        return SweepEngine<Sim>::measure(*sim);
+    }
+};
+
+/*
+ * ================================
+ * CLASS: ThreadBarrier
+ * ================================
+ * Reusable barrier for a fixed number of threads (std::barrier is C++20).
+ */
+class ThreadBarrier
+{
+public:
+    explicit ThreadBarrier(unsigned _count) : count(_count), waiting(0), generation(0) {}
+
+    void arriveAndWait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        uint64_t arrivedIn = generation;
+        if (++waiting == count)
+        {
+            waiting = 0;
+            ++generation;
+            released.notify_all();
+            return;
+        }
+        released.wait(lock, [&] { return generation != arrivedIn; });
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable released;
+    unsigned count;
+    unsigned waiting;
+    uint64_t generation;
+};
+
+/*
+ * ================================
+ * CLASS: ConservativeParallelSimulation
+ * ================================
+ * Conservative parallel engine for one very large scenario. The stations are
+ * split into contiguous groups, each run by a logical process (LP) with its
+ * own event queue, station selection and RNG; LPs are spread over threads.
+ *
+ * Travel gives the lookahead: a truck that leaves a station is out of every
+ * LP's hands for at least 2 x travel + minimum mining time, and its next
+ * arrival time is known the moment it leaves (the site side is fused, as with
+ * SimulationOptions::fuseTruckCycle). Time advances in windows of travelTime
+ * minutes. At the start of each window every truck due to arrive during it is
+ * routed to an LP, and then all LPs run the window without talking to each
+ * other. No truck routed later can arrive inside the window, so no LP ever
+ * receives an event in its past.
+ *
+ * Routing sees every truck due in the window at once and takes them in
+ * arrival order: each goes to the LP with the fewest trucks (queued or
+ * unloading) per bay at its arrival, forecast from the LP's count at the
+ * window start, the trucks already routed to it and what its bays unload
+ * meanwhile. This is join-shortest-queue between LPs on a forecast rebuilt
+ * every window. Within the LP, StationSelection picks the station on arrival
+ * using the live queues, as in Simulation.
+ *
+ * Results depend on the seed and the number of LPs, never on thread timing.
+ * With one LP the run is the same as Simulation with fuseTruckCycle. With
+ * more LPs a truck is committed to an LP before it arrives, on a forecast, so
+ * trucks wait somewhat longer than under Simulation's live choice: for 4000
+ * trucks at 96 stations, about 0.25 vs 0.22 minutes per load with 8 LPs of
+ * 12 stations, but about twice as long with 24 LPs of 4 stations. Loads and
+ * utilization stay within a fraction of a percent. A counter-based Rng
+ * (PhiloxRng) is keyed by the run's seed in every LP instead, so each truck
+ * still gets the same mining time for each cycle whatever the LP count.
+ * EventQueue must accept any truck ID whatever its capacity (not
+ * IndexedEventHeap), since each LP only sees the trucks it is hosting.
+ */
+template <typename EventQueue = BinaryHeapEventQueue,
+          typename StationSelection = ShortestQueueSelection,
+          typename Rng = MersenneTwisterRng,
+          typename Tick = double>
+class ConservativeParallelSimulation
+{
+    static_assert(!std::is_same<EventQueue, IndexedEventHeap>::value,
+                  "IndexedEventHeap needs every truck ID below its capacity");
+
+public:
+    /*
+     * numProcesses = 0 uses one LP per hardware thread (at most one per
+     * station); numThreads = 0 uses one thread per LP.
+     */
+    ConservativeParallelSimulation(int numTrucks, const std::vector<int> &stationBays, unsigned seed,
+                                   unsigned numProcesses = 0, unsigned _numThreads = 0,
+                                   SiteTiming _timing = SiteTiming())
+        : trucks(numTrucks), timing(_timing), numThreads(_numThreads), window(_timing.travelTime)
+    {
+        if (stationBays.empty())
+        {
+            throw std::invalid_argument("the parallel engine needs at least one station");
+        }
+        if (!timing.valid() || timing.travelTime < 1)
+        {
+            throw std::invalid_argument("the parallel engine needs valid timing and travelTime >= 1 (its lookahead)");
+        }
+        if (numProcesses == 0)
+        {
+            numProcesses = std::max(1u, std::thread::hardware_concurrency());
+        }
+        numProcesses = std::min(numProcesses, static_cast<unsigned>(stationBays.size()));
+        if (numThreads == 0 || numThreads > numProcesses)
+        {
+            numThreads = numProcesses;
+        }
+        backlogSnapshot.resize(numProcesses);
+
+        // Arrivals are at most 2 x travel + maximum mining after a departure
+        ringSize = (2 * timing.travelTime + timing.miningTimeMax) / window + 2;
+
+        size_t first = 0;
+        for (unsigned lp = 0; lp < numProcesses; ++lp)
+        {
+            size_t last = stationBays.size() * (lp + 1) / numProcesses;
+            std::vector<int> groupBays(stationBays.begin() + first, stationBays.begin() + last);
+            unsigned lpSeed = IsCounterBasedRng<Rng>::value ? seed : seed + lp;
+            processes.push_back(std::make_unique<LogicalProcess>(static_cast<int>(first), groupBays, trucks,
+                                                                 numProcesses, ringSize, lpSeed, timing, window));
+            first = last;
+        }
+    }
+
+    ConservativeParallelSimulation(int numTrucks, int numStations, unsigned seed, unsigned numProcesses = 0,
+                                   unsigned _numThreads = 0, SiteTiming _timing = SiteTiming())
+        : ConservativeParallelSimulation(numTrucks, std::vector<int>(numStations, 1), seed, numProcesses, _numThreads,
+                                         _timing)
+    {
+    }
+
+    // The LPs refer to the truck table, so the engine stays where it was built
+    ConservativeParallelSimulation(const ConservativeParallelSimulation &) = delete;
+    ConservativeParallelSimulation &operator=(const ConservativeParallelSimulation &) = delete;
+
+    /*
+     * Runs the simulation up to timing.simulationTime minutes.
+     */
+    void run()
+    {
+        ThreadBarrier barrier(numThreads);
+        auto work = [&](unsigned thread) {
+            // Every truck starts mining at an LP (truck i at LP i mod #LPs)
+            for (unsigned lp = thread; lp < processes.size(); lp += numThreads)
+            {
+                LogicalProcess &process = *processes[lp];
+                for (size_t truckId = lp; truckId < trucks.size(); truckId += processes.size())
+                {
+                    int truck = static_cast<int>(truckId);
+                    int miningTime = process.rng.miningTime(truck, trucks.loadsDelivered[truck]);
+                    process.scheduleFinishMining(truck, miningTime);
+                }
+                publishSnapshot(lp);
+            }
+            barrier.arriveAndWait();
+
+            // Every thread derives the same plan from the snapshots, so planning
+            // needs no extra barrier
+            RoutingPlan plan(processes.size());
+            for (int64_t w = 0; w * window <= timing.simulationTime; ++w)
+            {
+                // Route the trucks arriving during this window
+                planRouting(plan, w);
+                for (unsigned lp = thread; lp < processes.size(); lp += numThreads)
+                {
+                    route(lp, w, plan);
+                }
+                barrier.arriveAndWait();
+
+                // Run the window, then publish what the next routing sees. The
+                // due lists are only cleared now that no thread is planning.
+                double windowEnd = static_cast<double>((w + 1) * window);
+                for (unsigned lp = thread; lp < processes.size(); lp += numThreads)
+                {
+                    LogicalProcess &process = *processes[lp];
+                    process.departures[w % process.departures.size()].clear();
+                    process.receive(processes, lp);
+                    process.advance(windowEnd);
+                    publishSnapshot(lp);
+                }
+                barrier.arriveAndWait();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (unsigned thread = 1; thread < numThreads; ++thread)
+        {
+            threads.emplace_back(work, thread);
+        }
+        work(0);
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+        gatherStations();
+    }
+
+    const BasicTruckTable<Tick> &getTrucks() const { return trucks; }
+    const std::vector<Station> &getStations() const { return stations; } // filled in by run()
+    const SiteTiming &getTiming() const { return timing; }
+    unsigned getNumProcesses() const { return static_cast<unsigned>(processes.size()); }
+
+    uint64_t getEventsProcessed() const
+    {
+        uint64_t total = 0;
+        for (const auto &process : processes)
+        {
+            total += process->eventsProcessed;
+        }
+        return total;
+    }
+
+private:
+    // A truck on its way to the stations, due at `time`
+    struct Departure
+    {
+        double time;
+        int truckId;
+    };
+
+    /*
+     * One group of stations with the trucks currently routed to it. The
+     * handlers are Simulation's (StationHandlers); station IDs are local to
+     * the LP. trucks is the engine's table: a truck is only ever hosted by one
+     * LP at a time.
+     */
+    struct LogicalProcess : StationHandlers<LogicalProcess, Tick>
+    {
+        using Handlers = StationHandlers<LogicalProcess, Tick>;
+        using Handlers::onArriveStation;
+        using Handlers::onStartUnloading;
+        using Handlers::onFinishUnloading;
+
+        int firstStation; // global ID of local station 0
+        std::vector<Station> stations;
+        int totalBays;
+        StationSelection stationSelection;
+        Rng rng;
+        BasicTruckTable<Tick> &trucks;
+        SiteTiming timing;
+        int window; // minutes per time window
+        EventQueue eventQueue;
+        double currentTime;
+        std::vector<Event> immediateEvents;
+        size_t immediateHead;
+        uint64_t eventsProcessed;
+
+        std::vector<std::vector<Departure>> departures; // trucks hosted here, by arrival window (ring)
+        std::vector<std::vector<Departure>> outbox;     // trucks routed to each LP this window
+
+        LogicalProcess(int _firstStation, const std::vector<int> &bays, BasicTruckTable<Tick> &_trucks,
+                       unsigned numProcesses, int ringSize, unsigned seed, const SiteTiming &_timing, int _window)
+            : firstStation(_firstStation), totalBays(0), stationSelection(static_cast<int>(bays.size()), seed),
+              rng(seed, _timing), trucks(_trucks), timing(_timing), window(_window),
+              eventQueue(static_cast<int>(_trucks.size()) / numProcesses + 1), currentTime(0.0), immediateHead(0),
+              eventsProcessed(0), departures(ringSize), outbox(numProcesses)
+        {
+            stations.reserve(bays.size());
+            for (size_t i = 0; i < bays.size(); ++i)
+            {
+                if (bays[i] < 1)
+                {
+                    throw std::invalid_argument("every station needs at least one unload bay");
+                }
+                stations.push_back(Station(static_cast<int>(i), bays[i], timing.unloadTime));
+                totalBays += bays[i];
+            }
+            for (const auto &station : stations)
+            {
+                stationSelection.update(station, currentTime);
+            }
+        }
+
+        // Trucks queued or unloading
+        int64_t backlog() const
+        {
+            int64_t trucksHere = 0;
+            for (const auto &station : stations)
+            {
+                trucksHere += static_cast<int64_t>(station.truckQueue.size()) + station.busyBays;
+            }
+            return trucksHere;
+        }
+
+        /*
+         * The truck will finish mining at finishMining and then travel to the
+         * stations; file its arrival under the window it falls in.
+         */
+        void scheduleFinishMining(int truckId, double finishMining)
+        {
+            // Match Simulation, which never handles a FINISH_MINING past the end
+            if (finishMining <= timing.simulationTime)
+            {
+                trucks.totalTravelTime[truckId] += timing.travelTime;
+            }
+            double arrival = finishMining + timing.travelTime;
+            if (arrival <= timing.simulationTime)
+            {
+                int64_t w = static_cast<int64_t>(arrival) / window;
+                departures[w % departures.size()].push_back(Departure{arrival, truckId});
+            }
+        }
+
+        // Takes the trucks every LP routed here and queues their arrivals
+        void receive(std::vector<std::unique_ptr<LogicalProcess>> &processes, unsigned self)
+        {
+            for (auto &source : processes)
+            {
+                for (const Departure &departure : source->outbox[self])
+                {
+                    eventQueue.push(Event{departure.time, EventType::ARRIVE_STATION, 0, departure.truckId});
+                }
+            }
+        }
+
+        // Handles every event before endTime (and not past the end of the run)
+        void advance(double endTime)
+        {
+            while (true)
+            {
+                while (immediateHead < immediateEvents.size())
+                {
+                    Event evt = immediateEvents[immediateHead++];
+                    handleEvent(evt);
+                }
+                immediateEvents.clear();
+                immediateHead = 0;
+
+                if (eventQueue.empty() || eventQueue.top().time >= endTime ||
+                    eventQueue.top().time > timing.simulationTime)
+                {
+                    break;
+                }
+                Event evt = eventQueue.top();
+                eventQueue.pop();
+                currentTime = evt.time;
+                handleEvent(evt);
+            }
+        }
+
+        void scheduleEvent(double time, EventType type, int truckId)
+        {
+            Event evt{time, type, 0, truckId};
+            if (time <= currentTime)
+            {
+                immediateEvents.push_back(evt);
+                return;
+            }
+            eventQueue.push(evt);
+        }
+
+        void handleEvent(const Event &evt)
+        {
+            ++eventsProcessed;
+            switch (evt.type)
+            {
+            case EventType::ARRIVE_STATION:
+                onArriveStation(evt.truckId);
+                break;
+            case EventType::START_UNLOADING:
+                onStartUnloading(evt.truckId);
+                break;
+            case EventType::FINISH_UNLOADING:
+                onFinishUnloading(evt.truckId);
+                break;
+            default:
+                break;
+            }
+        }
+    };
+
+    BasicTruckTable<Tick> trucks;
+    SiteTiming timing;
+    unsigned numThreads;
+    int window; // minutes per time window (the lookahead)
+    int ringSize;
+    std::vector<std::unique_ptr<LogicalProcess>> processes;
+    std::vector<int64_t> backlogSnapshot; // trucks queued or unloading at each LP at the window start
+    std::vector<Station> stations;        // every station with its global ID, gathered after run()
+
+    // A truck due in the window; number counts the due trucks LP by LP
+    struct DueTruck
+    {
+        double time;
+        int truckId;
+        int64_t number;
+    };
+
+    /*
+     * Where the window's due trucks go. Number them LP by LP (LP 0's first, in
+     * the order each LP filed them); truck n goes to LP destination[n].
+     */
+    struct RoutingPlan
+    {
+        std::vector<int64_t> sourceStart;  // number of LP s's first due truck
+        std::vector<unsigned> destination; // LP each due truck is routed to
+        std::vector<DueTruck> arrivals;    // every due truck, in (time, truck ID) order
+        std::vector<double> backlog;       // forecast trucks queued or unloading at each LP
+
+        explicit RoutingPlan(size_t numProcesses) : sourceStart(numProcesses + 1), backlog(numProcesses) {}
+    };
+
+    void publishSnapshot(unsigned lp) { backlogSnapshot[lp] = processes[lp]->backlog(); }
+
+    /*
+     * Join-shortest-queue between LPs on a forecast: takes the trucks due in
+     * window w in arrival order and sends each to the LP with the fewest
+     * trucks per bay at that moment, counting from the snapshot at the window
+     * start, plus the trucks already routed there, minus what the busy bays
+     * have unloaded since. Every thread reads the same due lists and
+     * snapshots, so every thread derives the same plan.
+     */
+    void planRouting(RoutingPlan &plan, int64_t w) const
+    {
+        size_t numProcesses = processes.size();
+        plan.arrivals.clear();
+        plan.sourceStart[0] = 0;
+        for (size_t lp = 0; lp < numProcesses; ++lp)
+        {
+            const std::vector<Departure> &due = processes[lp]->departures[w % processes[lp]->departures.size()];
+            for (size_t i = 0; i < due.size(); ++i)
+            {
+                int64_t number = plan.sourceStart[lp] + static_cast<int64_t>(i);
+                plan.arrivals.push_back(DueTruck{due[i].time, due[i].truckId, number});
+            }
+            plan.sourceStart[lp + 1] = plan.sourceStart[lp] + static_cast<int64_t>(due.size());
+            plan.backlog[lp] = static_cast<double>(backlogSnapshot[lp]);
+        }
+        std::sort(plan.arrivals.begin(), plan.arrivals.end(), [](const DueTruck &a, const DueTruck &b) {
+            return a.time < b.time || (a.time == b.time && a.truckId < b.truckId);
+        });
+        plan.destination.resize(plan.arrivals.size());
+
+        double lastTime = static_cast<double>(w * window);
+        for (const DueTruck &truck : plan.arrivals)
+        {
+            double elapsed = truck.time - lastTime;
+            lastTime = truck.time;
+            unsigned best = 0;
+            double bestPerBay = 0.0;
+            for (size_t lp = 0; lp < numProcesses; ++lp)
+            {
+                double bays = processes[lp]->totalBays;
+                if (elapsed > 0.0)
+                {
+                    // Each bay holding a truck unloads 1 / unloadTime trucks a minute
+                    double busy = std::min(bays, plan.backlog[lp]);
+                    double unloaded = timing.unloadTime > 0 ? busy * elapsed / timing.unloadTime : plan.backlog[lp];
+                    plan.backlog[lp] = std::max(0.0, plan.backlog[lp] - unloaded);
+                }
+                double perBay = (plan.backlog[lp] + 1.0) / bays;
+                if (lp == 0 || perBay < bestPerBay)
+                {
+                    best = static_cast<unsigned>(lp);
+                    bestPerBay = perBay;
+                }
+            }
+            plan.backlog[best] += 1.0;
+            plan.destination[truck.number] = best;
+        }
+    }
+
+    /*
+     * Sends each truck lp has due in window w to the LP the plan gives it.
+     */
+    void route(unsigned lp, int64_t w, const RoutingPlan &plan)
+    {
+        LogicalProcess &process = *processes[lp];
+        for (std::vector<Departure> &box : process.outbox)
+        {
+            box.clear();
+        }
+
+        const std::vector<Departure> &due = process.departures[w % process.departures.size()];
+        for (size_t i = 0; i < due.size(); ++i)
+        {
+            process.outbox[plan.destination[plan.sourceStart[lp] + static_cast<int64_t>(i)]].push_back(due[i]);
+        }
+    }
+
+    void gatherStations()
+    {
+        stations.clear();
+        for (const auto &process : processes)
+        {
+            for (const Station &station : process->stations)
+            {
+                stations.push_back(station);
+                stations.back().id = process->firstStation + station.id;
+            }
+        }
+    }
+};
+
+/*
+ * ================================
+ * STRUCT: TimeWarpStats
+ * ================================
+ * How much speculative work an optimistic run did and how much of it was kept.
+ */
+struct TimeWarpStats
+{
+    uint64_t eventsProcessed = 0;  // events handled, including ones later rolled back
+    uint64_t eventsRolledBack = 0; // events undone by rollbacks
+    uint64_t rollbacks = 0;        // stragglers and anti-messages that forced a rollback
+    uint64_t antiMessages = 0;     // arrivals cancelled at another LP
+    uint64_t gvtRounds = 0;        // rounds between GVT computations
+
+    uint64_t eventsCommitted() const { return eventsProcessed - eventsRolledBack; }
+
+    // Fraction of handled events that were undone
+    double rollbackRate() const
+    {
+        return eventsProcessed == 0 ? 0.0 : static_cast<double>(eventsRolledBack) / eventsProcessed;
+    }
+
+    // Committed over processed events. The speedup over the same LPs on one
+    // thread is at most efficiency x threads; below 1 / threads the optimistic
+    // run cannot win.
+    double efficiency() const
+    {
+        return eventsProcessed == 0 ? 1.0 : static_cast<double>(eventsCommitted()) / eventsProcessed;
+    }
+
+    TimeWarpStats &operator+=(const TimeWarpStats &other)
+    {
+        eventsProcessed += other.eventsProcessed;
+        eventsRolledBack += other.eventsRolledBack;
+        rollbacks += other.rollbacks;
+        antiMessages += other.antiMessages;
+        return *this;
+    }
+};
+
+// PowerOfDChoicesSelection keeps a sampling stream that rollbacks cannot restore
+template <typename StationSelection>
+struct IsPowerOfDChoices : std::false_type
+{
+};
+
+template <int D>
+struct IsPowerOfDChoices<PowerOfDChoicesSelection<D>> : std::true_type
+{
+};
+
+/*
+ * ================================
+ * CLASS: TimeWarpSimulation
+ * ================================
+ * Optimistic (Time Warp) parallel engine. As in ConservativeParallelSimulation
+ * the stations are split into contiguous groups, each a logical process (LP)
+ * with its own stations, truck queues, event queue, station selection and RNG,
+ * and the site side is fused (SimulationOptions::fuseTruckCycle). LPs do not
+ * wait for each other: each handles its events in (time, truck ID) order as
+ * far as it can, using the same Event and handleEvent dispatch as Simulation.
+ *
+ * When a truck leaves a station, its ARRIVE_STATION is sent to the LP picked
+ * by a hash of (seed, truck, arrival time), weighted by bays. This is a
+ * different dispatch model from Simulation and ConservativeParallelSimulation:
+ * the LP is chosen at random, and only the station within it by the live
+ * queues. Routing on other LPs' queues would make the result depend on how
+ * far each LP had run. Trucks therefore wait longer than under Simulation,
+ * more so with many small LPs (about 0.85 vs 0.15 minutes per load for 4000
+ * trucks at 96 stations in 8 LPs), though far less than with two random
+ * choices per truck (PowerOfDChoicesSelection<2>, about 3). An arrival that
+ * lands in an LP's past (a straggler) rolls the LP back to just before it:
+ * every handler saves what it is about to overwrite (truck fields, station
+ * state, the mining-time stream), and undoing a step puts those back, cancels
+ * the events it queued, and sends an anti-message for every arrival it sent
+ * elsewhere. An anti-message rolls its receiver back in turn if needed.
+ *
+ * Every round, each LP handles up to stepsPerRound events; then all threads
+ * meet and compute GVT, the earliest event or message still pending anywhere.
+ * Nothing before GVT can be rolled back, so its saved state is dropped (fossil
+ * collection). The run ends once GVT passes timing.simulationTime.
+ *
+ * A rollback restores exactly what was there, so the result is that of
+ * handling each LP's events in order: it depends on the seed and the number of
+ * LPs, never on threads or stepsPerRound. With one LP the run is the same as
+ * Simulation with fuseTruckCycle. Each LP keeps its own share of every truck's
+ * statistics (an LP that rolls back must not touch a truck another LP has
+ * since taken over); getTrucks() sums them after run(). The truck's cycle
+ * (its loads delivered over all LPs) travels with each arrival instead, in
+ * the message and in Event::generation, and is what an LP passes to the RNG.
+ * A counter-based Rng is keyed with the run's seed at every LP, as in
+ * ConservativeParallelSimulation, so each truck draws the same mining times
+ * as in Simulation; other RNGs use seed + LP index.
+ *
+ * Rolled-back events come back in the past, so the event queue is always the
+ * non-monotone BinaryHeapEventQueue. getStats() reports the rollback rate and
+ * efficiency; compare run times against the same LPs on one thread, which
+ * compute the identical result (above one LP, Simulation::run() does not).
+ */
+template <typename StationSelection = ShortestQueueSelection,
+          typename Rng = MersenneTwisterRng,
+          typename Tick = double>
+class TimeWarpSimulation
+{
+    static_assert(!IsPowerOfDChoices<StationSelection>::value,
+                  "a rollback cannot restore PowerOfDChoicesSelection's sampling stream");
+
+public:
+    static const unsigned DEFAULT_STEPS_PER_ROUND = 1024;
+
+    /*
+     * numProcesses = 0 uses one LP per hardware thread (at most one per
+     * station); numThreads = 0 uses one thread per LP.
+     */
+    TimeWarpSimulation(int numTrucks, const std::vector<int> &_stationBays, unsigned _seed,
+                       unsigned numProcesses = 0, unsigned _numThreads = 0, unsigned _stepsPerRound = DEFAULT_STEPS_PER_ROUND,
+                       SiteTiming _timing = SiteTiming())
+        : trucks(numTrucks), stationBays(_stationBays), timing(_timing), seed(_seed), numThreads(_numThreads),
+          stepsPerRound(_stepsPerRound), hasRun(false)
+    {
+        if (stationBays.empty())
+        {
+            throw std::invalid_argument("the optimistic engine needs at least one station");
+        }
+        if (!timing.valid() || timing.travelTime < 1)
+        {
+            throw std::invalid_argument("the optimistic engine needs valid timing and travelTime >= 1");
+        }
+        if (stepsPerRound < 1)
+        {
+            throw std::invalid_argument("the optimistic engine needs at least one step per round");
+        }
+        // Arrivals carry the truck's cycle in the 16-bit Event::generation
+        int shortestCycle = std::max(1, timing.miningTimeMin + 2 * timing.travelTime + timing.unloadTime);
+        if (timing.simulationTime / shortestCycle >= std::numeric_limits<uint16_t>::max())
+        {
+            throw std::invalid_argument("the optimistic engine counts at most 65535 loads per truck");
+        }
+        if (numProcesses == 0)
+        {
+            numProcesses = std::max(1u, std::thread::hardware_concurrency());
+        }
+        numProcesses = std::min(numProcesses, static_cast<unsigned>(stationBays.size()));
+        if (numThreads == 0 || numThreads > numProcesses)
+        {
+            numThreads = numProcesses;
+        }
+        buildProcesses(numProcesses);
+    }
+
+    TimeWarpSimulation(int numTrucks, int numStations, unsigned _seed, unsigned numProcesses = 0,
+                       unsigned _numThreads = 0, unsigned _stepsPerRound = DEFAULT_STEPS_PER_ROUND,
+                       SiteTiming _timing = SiteTiming())
+        : TimeWarpSimulation(numTrucks, std::vector<int>(numStations, 1), _seed, numProcesses, _numThreads,
+                             _stepsPerRound, _timing)
+    {
+    }
+
+    // The LPs refer to the engine, so it stays where it was built
+    TimeWarpSimulation(const TimeWarpSimulation &) = delete;
+    TimeWarpSimulation &operator=(const TimeWarpSimulation &) = delete;
+
+    /*
+     * Runs the simulation up to timing.simulationTime minutes.
+     */
+    void run()
+    {
+        // The last round of a run does not fossil-collect, so the LPs still
+        // hold its logs; a second run starts over from fresh ones
+        if (hasRun)
+        {
+            buildProcesses(static_cast<unsigned>(processes.size()));
+        }
+        hasRun = true;
+        stats = TimeWarpStats();
+
+        // Every truck starts mining at an LP (truck i at LP i mod #LPs); nothing
+        // runs yet, so these first arrivals are never rolled back
+        for (auto &process : processes)
+        {
+            for (size_t truckId = process->index; truckId < trucks.size(); truckId += processes.size())
+            {
+                int miningTime = process->drawMiningTime(static_cast<int>(truckId), 0);
+                process->scheduleFinishMining(static_cast<int>(truckId), miningTime);
+            }
+        }
+        for (auto &process : processes)
+        {
+            process->sentLog.clear();
+            process->scheduledLog.clear();
+            process->drawLog.clear();
+            process->saveRng();
+        }
+
+        ThreadBarrier barrier(numThreads);
+        std::vector<double> earliest(processes.size());
+        auto work = [&](unsigned thread) {
+            while (true)
+            {
+                for (unsigned lp = thread; lp < processes.size(); lp += numThreads)
+                {
+                    processes[lp]->execute(stepsPerRound);
+                }
+                barrier.arriveAndWait();
+
+                // Nobody sends now, so every pending event and message is in sight
+                for (unsigned lp = thread; lp < processes.size(); lp += numThreads)
+                {
+                    earliest[lp] = processes[lp]->earliestPending();
+                }
+                barrier.arriveAndWait();
+
+                double gvt = *std::min_element(earliest.begin(), earliest.end());
+                if (thread == 0)
+                {
+                    ++stats.gvtRounds;
+                }
+                if (gvt > timing.simulationTime)
+                {
+                    break;
+                }
+                for (unsigned lp = thread; lp < processes.size(); lp += numThreads)
+                {
+                    processes[lp]->collectFossils(gvt);
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (unsigned thread = 1; thread < numThreads; ++thread)
+        {
+            threads.emplace_back(work, thread);
+        }
+        work(0);
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+        gather();
+    }
+
+    const BasicTruckTable<Tick> &getTrucks() const { return trucks; }     // filled in by run()
+    const std::vector<Station> &getStations() const { return stations; } // filled in by run()
+    const SiteTiming &getTiming() const { return timing; }
+    unsigned getNumProcesses() const { return static_cast<unsigned>(processes.size()); }
+    const TimeWarpStats &getStats() const { return stats; } // filled in by run()
+
+    // Committed events, comparable with Simulation::getEventsProcessed()
+    uint64_t getEventsProcessed() const { return stats.eventsCommitted(); }
+
+private:
+    // An ARRIVE_STATION sent to another LP, or its cancellation
+    struct Message
+    {
+        double time;
+        int truckId;
+        int cycle; // loads the truck has delivered so far, at any LP
+        bool anti;
+    };
+
+    // An arrival a step sent to another LP, kept until the step is committed
+    struct SentMessage
+    {
+        double time;
+        int truckId;
+        int cycle;
+        unsigned destination;
+    };
+
+    // A truck's fields before a step overwrote them
+    struct TruckRecord
+    {
+        int truckId;
+        double arrivalEventTime;
+        int stationId;
+        int nextInQueue;
+        int loadsDelivered;
+        int cycle;
+        Tick totalWaitTime;
+        Tick totalTravelTime;
+        Tick totalMiningTime;
+        Tick totalUnloadTime;
+    };
+
+    // A station before a step changed it; its bays follow in bayLog
+    struct StationRecord
+    {
+        int stationId;
+        int busyBays;
+        double totalBusyTime;
+        TruckQueue truckQueue;
+        double updatedAt;
+    };
+
+    // Mining-time stream after `draws` draws
+    struct RngSnapshot
+    {
+        uint64_t draws;
+        Rng rng;
+    };
+
+    /*
+     * One queued event with its zero-delay follow-ups, and how many entries of
+     * each log it added (so it can be undone, or dropped once committed).
+     */
+    struct Step
+    {
+        Event evt;
+        uint32_t events;
+        uint32_t truckRecords;
+        uint32_t stationRecords;
+        uint32_t sent;
+        uint32_t scheduled;
+        uint64_t drawsBefore;
+    };
+
+    /*
+     * One group of stations. The handlers are Simulation's (StationHandlers),
+     * with hooks that save what each handler overwrites first; station IDs
+     * are local to the LP.
+     */
+    struct LogicalProcess : StationHandlers<LogicalProcess, Tick>
+    {
+        using Handlers = StationHandlers<LogicalProcess, Tick>;
+        friend Handlers;
+        using Handlers::onArriveStation;
+        using Handlers::onStartUnloading;
+        using Handlers::onFinishUnloading;
+
+        static const uint64_t RNG_SNAPSHOT_INTERVAL = 256; // mining draws between RNG snapshots
+
+        TimeWarpSimulation &sim;
+        unsigned index;
+        int firstStation; // global ID of local station 0
+        std::vector<Station> stations;
+        std::vector<double> stationUpdatedAt; // `now` of each station's last stationSelection.update()
+        int totalBays;
+        StationSelection stationSelection;
+        Rng rng;
+        BasicTruckTable<Tick> trucks; // this LP's share of every truck's statistics
+        std::vector<int> cycle;       // each truck's loads over all LPs, as of its last arrival here
+        SiteTiming timing;
+        BinaryHeapEventQueue eventQueue;
+        std::map<std::pair<double, int64_t>, uint32_t> cancelled; // queued events to drop when popped
+        double currentTime;
+        std::vector<Event> immediateEvents;
+        size_t immediateHead;
+        TimeWarpStats stats;
+
+        // Saved state of the steps since GVT, oldest first
+        std::deque<Step> steps;
+        std::deque<TruckRecord> truckLog;
+        std::deque<StationRecord> stationLog;
+        std::deque<double> bayLog; // bayBusyUntil, bayBusyTime of each bay of each StationRecord
+        std::deque<SentMessage> sentLog;
+        std::deque<Event> scheduledLog; // events a step queued here
+        std::deque<RngSnapshot> rngSnapshots;
+        std::deque<std::pair<int, int>> drawLog; // (truck, cycle) of every mining draw since rngSnapshots.front()
+        uint64_t draws;          // mining draws so far
+
+        // Messages from other LPs
+        std::mutex inboxMutex;
+        std::vector<Message> inbox;
+        std::vector<Message> delivered;
+        std::atomic<bool> hasMail;
+
+        LogicalProcess(TimeWarpSimulation &_sim, unsigned _index, int _firstStation, const std::vector<int> &bays,
+                       int numTrucks, unsigned seed, const SiteTiming &_timing)
+            : sim(_sim), index(_index), firstStation(_firstStation), stationUpdatedAt(bays.size(), 0.0), totalBays(0),
+              stationSelection(static_cast<int>(bays.size()), seed), rng(seed, _timing), trucks(numTrucks),
+              cycle(numTrucks, 0), timing(_timing), eventQueue(numTrucks), currentTime(0.0), immediateHead(0),
+              draws(0), hasMail(false)
+        {
+            stations.reserve(bays.size());
+            for (size_t i = 0; i < bays.size(); ++i)
+            {
+                if (bays[i] < 1)
+                {
+                    throw std::invalid_argument("every station needs at least one unload bay");
+                }
+                stations.push_back(Station(static_cast<int>(i), bays[i], timing.unloadTime));
+                totalBays += bays[i];
+            }
+            for (const auto &station : stations)
+            {
+                stationSelection.update(station, currentTime);
+            }
+        }
+
+        // Called by the sending LP's thread
+        void post(const Message &message)
+        {
+            std::lock_guard<std::mutex> lock(inboxMutex);
+            inbox.push_back(message);
+            hasMail.store(true, std::memory_order_release);
+        }
+
+        /*
+         * Handles up to maxSteps queued events (each with its zero-delay
+         * follow-ups) no later than the end of the run, reading mail first.
+         */
+        void execute(unsigned maxSteps)
+        {
+            for (unsigned i = 0; i < maxSteps; ++i)
+            {
+                if (hasMail.load(std::memory_order_acquire))
+                {
+                    receive();
+                }
+                Event evt;
+                if (!popNextEvent(timing.simulationTime, evt))
+                {
+                    break;
+                }
+                runStep(evt);
+            }
+            if (hasMail.load(std::memory_order_acquire))
+            {
+                receive();
+            }
+        }
+
+        // Earliest live event or message at this LP (only while nobody sends)
+        double earliestPending()
+        {
+            double earliest = std::numeric_limits<double>::infinity();
+            while (!eventQueue.empty() && takeCancelled(eventQueue.top()))
+            {
+                eventQueue.pop();
+            }
+            if (!eventQueue.empty())
+            {
+                earliest = eventQueue.top().time;
+            }
+            for (const Message &message : inbox)
+            {
+                earliest = std::min(earliest, message.time);
+            }
+            return earliest;
+        }
+
+        /*
+         * Drops the saved state of every step before gvt: no message can
+         * arrive before gvt any more, so those steps are final.
+         */
+        void collectFossils(double gvt)
+        {
+            while (!steps.empty() && steps.front().evt.time < gvt)
+            {
+                const Step &step = steps.front();
+                truckLog.erase(truckLog.begin(), truckLog.begin() + step.truckRecords);
+                for (uint32_t i = 0; i < step.stationRecords; ++i)
+                {
+                    bayLog.erase(bayLog.begin(), bayLog.begin() + 2 * stations[stationLog.front().stationId].bays);
+                    stationLog.pop_front();
+                }
+                sentLog.erase(sentLog.begin(), sentLog.begin() + step.sent);
+                scheduledLog.erase(scheduledLog.begin(), scheduledLog.begin() + step.scheduled);
+                steps.pop_front();
+            }
+
+            // Keep the newest snapshot the oldest remaining step can roll back to
+            uint64_t oldest = steps.empty() ? draws : steps.front().drawsBefore;
+            while (rngSnapshots.size() > 1 && rngSnapshots[1].draws <= oldest)
+            {
+                drawLog.erase(drawLog.begin(), drawLog.begin() + (rngSnapshots[1].draws - rngSnapshots[0].draws));
+                rngSnapshots.pop_front();
+            }
+        }
+
+        int drawMiningTime(int truckId, int truckCycle)
+        {
+            drawLog.emplace_back(truckId, truckCycle);
+            ++draws;
+            return rng.miningTime(truckId, truckCycle);
+        }
+
+        void saveRng() { rngSnapshots.push_back(RngSnapshot{draws, rng}); }
+
+        /*
+         * The truck will finish mining at finishMining and then travel to the
+         * stations; send its arrival to the LP that will host it.
+         */
+        void scheduleFinishMining(int truckId, double finishMining)
+        {
+            // Match Simulation, which never handles a FINISH_MINING past the end
+            if (finishMining <= timing.simulationTime)
+            {
+                trucks.totalTravelTime[truckId] += timing.travelTime;
+            }
+            double arrival = finishMining + timing.travelTime;
+            if (arrival > timing.simulationTime)
+            {
+                return;
+            }
+            unsigned destination = sim.destination(truckId, arrival);
+            if (destination == index)
+            {
+                scheduleEvent(arrival, EventType::ARRIVE_STATION, truckId, static_cast<uint16_t>(cycle[truckId]));
+                return;
+            }
+            sentLog.push_back(SentMessage{arrival, truckId, cycle[truckId], destination});
+            sim.processes[destination]->post(Message{arrival, truckId, cycle[truckId], false});
+        }
+
+    private:
+        /*
+         * Marks a queued event to be dropped when popped. A truck can have
+         * several events queued here after a rollback (e.g. an arrival put back
+         * and a later one not yet cancelled by its sender), so cancellation
+         * goes by the whole event, not by truck. Equal events are
+         * interchangeable, so a count per event is enough.
+         */
+        void cancel(const Event &evt)
+        {
+            ++cancelled[cancelKey(evt)];
+        }
+
+        // True (and forgets the mark) if evt was cancelled
+        bool takeCancelled(const Event &evt)
+        {
+            if (cancelled.empty())
+            {
+                return false;
+            }
+            auto it = cancelled.find(cancelKey(evt));
+            if (it == cancelled.end())
+            {
+                return false;
+            }
+            if (--it->second == 0)
+            {
+                cancelled.erase(it);
+            }
+            return true;
+        }
+
+        /*
+         * An arrival for a truck that is still at one of our stations comes from
+         * a speculative copy of the truck (its own or the one here), which a
+         * rollback is bound to cancel. Handling it would link the truck into two
+         * queues, so the LP waits for the cancellation instead. Events at GVT
+         * are never doomed, so this cannot stall the run.
+         */
+        bool isDoomed(const Event &evt) const
+        {
+            return evt.type == EventType::ARRIVE_STATION && trucks.stationId[evt.truckId] != -1;
+        }
+
+        static std::pair<double, int64_t> cancelKey(const Event &evt)
+        {
+            return std::make_pair(evt.time, static_cast<int64_t>(evt.truckId) << 24 |
+                                                static_cast<int64_t>(evt.generation) << 8 | static_cast<int>(evt.type));
+        }
+
+        bool popNextEvent(double endTime, Event &evt)
+        {
+            while (!eventQueue.empty())
+            {
+                evt = eventQueue.top();
+                if (takeCancelled(evt))
+                {
+                    eventQueue.pop();
+                    continue;
+                }
+                if (evt.time > endTime || isDoomed(evt))
+                {
+                    return false;
+                }
+                eventQueue.pop();
+                return true;
+            }
+            return false;
+        }
+
+        // Handles evt and its zero-delay follow-ups as one undoable step
+        void runStep(const Event &evt)
+        {
+            if (draws - rngSnapshots.back().draws >= RNG_SNAPSHOT_INTERVAL)
+            {
+                saveRng();
+            }
+            size_t truckRecords = truckLog.size();
+            size_t stationRecords = stationLog.size();
+            size_t sent = sentLog.size();
+            size_t scheduled = scheduledLog.size();
+            uint64_t drawsBefore = draws;
+
+            currentTime = evt.time;
+            uint32_t events = 1;
+            handleEvent(evt);
+            while (immediateHead < immediateEvents.size())
+            {
+                Event next = immediateEvents[immediateHead++];
+                ++events;
+                handleEvent(next);
+            }
+            immediateEvents.clear();
+            immediateHead = 0;
+
+            steps.push_back(Step{evt, events, static_cast<uint32_t>(truckLog.size() - truckRecords),
+                                 static_cast<uint32_t>(stationLog.size() - stationRecords),
+                                 static_cast<uint32_t>(sentLog.size() - sent),
+                                 static_cast<uint32_t>(scheduledLog.size() - scheduled), drawsBefore});
+            stats.eventsProcessed += events;
+        }
+
+        // Takes the mail: arrivals are queued, cancellations drop theirs
+        void receive()
+        {
+            {
+                std::lock_guard<std::mutex> lock(inboxMutex);
+                delivered.swap(inbox);
+                hasMail.store(false, std::memory_order_relaxed);
+            }
+            for (const Message &message : delivered)
+            {
+                Event evt{message.time, EventType::ARRIVE_STATION, static_cast<uint16_t>(message.cycle),
+                          message.truckId};
+                if (message.anti)
+                {
+                    // Undo the arrival itself too if it was handled, then
+                    // drop it from the queue
+                    rollBack(evt, true);
+                    cancel(evt);
+                    continue;
+                }
+                rollBack(evt, false);
+                eventQueue.push(evt);
+            }
+            delivered.clear();
+        }
+
+        /*
+         * Undoes every handled step that comes after evt in (time, truck ID)
+         * order, or at evt too if inclusive, newest first.
+         */
+        void rollBack(const Event &evt, bool inclusive)
+        {
+            auto undo = [&](const Event &stepEvent) {
+                return stepEvent > evt ||
+                       (inclusive && stepEvent.time == evt.time && stepEvent.truckId == evt.truckId);
+            };
+            if (steps.empty() || !undo(steps.back().evt))
+            {
+                return;
+            }
+            ++stats.rollbacks;
+
+            uint64_t drawsBefore = draws;
+            while (!steps.empty() && undo(steps.back().evt))
+            {
+                drawsBefore = steps.back().drawsBefore;
+                undoStep();
+            }
+            restoreRng(drawsBefore);
+        }
+
+        void undoStep()
+        {
+            Step step = steps.back();
+            steps.pop_back();
+
+            // Newest records first, so each field ends up with its oldest saved value
+            for (uint32_t i = 0; i < step.truckRecords; ++i)
+            {
+                const TruckRecord &record = truckLog.back();
+                int truckId = record.truckId;
+                trucks.arrivalEventTime[truckId] = record.arrivalEventTime;
+                trucks.stationId[truckId] = record.stationId;
+                trucks.nextInQueue[truckId] = record.nextInQueue;
+                trucks.loadsDelivered[truckId] = record.loadsDelivered;
+                cycle[truckId] = record.cycle;
+                trucks.totalWaitTime[truckId] = record.totalWaitTime;
+                trucks.totalTravelTime[truckId] = record.totalTravelTime;
+                trucks.totalMiningTime[truckId] = record.totalMiningTime;
+                trucks.totalUnloadTime[truckId] = record.totalUnloadTime;
+                truckLog.pop_back();
+            }
+            for (uint32_t i = 0; i < step.stationRecords; ++i)
+            {
+                const StationRecord &record = stationLog.back();
+                Station &station = stations[record.stationId];
+                for (int bay = station.bays - 1; bay >= 0; --bay)
+                {
+                    station.bayBusyTime[bay] = bayLog.back();
+                    bayLog.pop_back();
+                    station.bayBusyUntil[bay] = bayLog.back();
+                    bayLog.pop_back();
+                }
+                station.busyBays = record.busyBays;
+                station.totalBusyTime = record.totalBusyTime;
+                station.truckQueue = record.truckQueue;
+                stationUpdatedAt[record.stationId] = record.updatedAt;
+                stationSelection.update(station, record.updatedAt);
+                stationLog.pop_back();
+            }
+
+            // Cancel what the step queued here and sent elsewhere
+            for (uint32_t i = 0; i < step.scheduled; ++i)
+            {
+                cancel(scheduledLog.back());
+                scheduledLog.pop_back();
+            }
+            for (uint32_t i = 0; i < step.sent; ++i)
+            {
+                const SentMessage &sent = sentLog.back();
+                sim.processes[sent.destination]->post(Message{sent.time, sent.truckId, sent.cycle, true});
+                ++stats.antiMessages;
+                sentLog.pop_back();
+            }
+
+            // The event itself is pending again
+            eventQueue.push(step.evt);
+            stats.eventsRolledBack += step.events;
+        }
+
+        // Back to the stream after `target` draws: the newest snapshot at or
+        // before it, then the logged draws up to it
+        void restoreRng(uint64_t target)
+        {
+            while (rngSnapshots.back().draws > target)
+            {
+                rngSnapshots.pop_back();
+            }
+            rng = rngSnapshots.back().rng;
+            uint64_t firstLogged = rngSnapshots.front().draws;
+            for (uint64_t draw = rngSnapshots.back().draws; draw < target; ++draw)
+            {
+                const std::pair<int, int> &logged = drawLog[draw - firstLogged];
+                rng.miningTime(logged.first, logged.second);
+            }
+            drawLog.resize(target - firstLogged);
+            draws = target;
+        }
+
+        void saveTruck(int truckId)
+        {
+            truckLog.push_back(TruckRecord{truckId, trucks.arrivalEventTime[truckId], trucks.stationId[truckId],
+                                           trucks.nextInQueue[truckId], trucks.loadsDelivered[truckId], cycle[truckId],
+                                           trucks.totalWaitTime[truckId], trucks.totalTravelTime[truckId],
+                                           trucks.totalMiningTime[truckId], trucks.totalUnloadTime[truckId]});
+        }
+
+        void saveStation(const Station &station)
+        {
+            stationLog.push_back(StationRecord{station.id, station.busyBays, station.totalBusyTime,
+                                               station.truckQueue, stationUpdatedAt[station.id]});
+            for (int bay = 0; bay < station.bays; ++bay)
+            {
+                bayLog.push_back(station.bayBusyUntil[bay]);
+                bayLog.push_back(station.bayBusyTime[bay]);
+            }
+        }
+
+        void updateSelection(const Station &station)
+        {
+            stationSelection.update(station, currentTime);
+            stationUpdatedAt[station.id] = currentTime;
+        }
+
+        // The caller has saved the truck
+        int nextMiningTime(int truckId) { return drawMiningTime(truckId, ++cycle[truckId]); }
+
+        // An ARRIVE_STATION carries the truck's cycle as its generation
+        void scheduleEvent(double time, EventType type, int truckId, uint16_t generation = 0)
+        {
+            Event evt{time, type, generation, truckId};
+            if (time <= currentTime)
+            {
+                immediateEvents.push_back(evt);
+                return;
+            }
+            eventQueue.push(evt);
+            scheduledLog.push_back(evt);
+        }
+
+        void handleEvent(const Event &evt)
+        {
+            switch (evt.type)
+            {
+            case EventType::ARRIVE_STATION:
+                // onArriveStation saved the truck, so undoing the step restores its cycle too
+                onArriveStation(evt.truckId);
+                cycle[evt.truckId] = evt.generation;
+                break;
+            case EventType::START_UNLOADING:
+                onStartUnloading(evt.truckId);
+                break;
+            case EventType::FINISH_UNLOADING:
+                onFinishUnloading(evt.truckId);
+                break;
+            default:
+                break;
+            }
+        }
+    };
+
+    BasicTruckTable<Tick> trucks; // summed over the LPs by run()
+    std::vector<int> stationBays;
+    SiteTiming timing;
+    unsigned seed;
+    unsigned numThreads;
+    unsigned stepsPerRound; // events each LP handles between GVT computations
+    bool hasRun;
+    std::vector<std::unique_ptr<LogicalProcess>> processes;
+    std::vector<int64_t> firstBay; // bays before each LP; the last entry is the total
+    std::vector<Station> stations; // every station with its global ID, gathered after run()
+    TimeWarpStats stats;
+
+    /*
+     * LP hosting the truck's arrival at `arrival`: a bay picked by a hash of
+     * (seed, truck, arrival time), so it is the same however often the sending
+     * step is redone. This is random dispatch between LPs; it never looks at
+     * their queues.
+     */
+    unsigned destination(int truckId, double arrival) const
+    {
+        if (processes.size() == 1)
+        {
+            return 0;
+        }
+        uint64_t x = (static_cast<uint64_t>(seed) << 32 | static_cast<uint32_t>(truckId)) ^
+                     static_cast<uint64_t>(static_cast<int64_t>(arrival)) * 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        x ^= x >> 31;
+        int64_t bay = static_cast<int64_t>(((x >> 32) * static_cast<uint64_t>(firstBay.back())) >> 32);
+        return static_cast<unsigned>(std::upper_bound(firstBay.begin() + 1, firstBay.end(), bay) -
+                                     (firstBay.begin() + 1));
+    }
+
+    // Sums every LP's share of the truck statistics and gathers the stations
+    // Splits the stations into numProcesses contiguous groups, one new LP each
+    void buildProcesses(unsigned numProcesses)
+    {
+        processes.clear();
+        firstBay.assign(1, 0);
+        size_t first = 0;
+        for (unsigned lp = 0; lp < numProcesses; ++lp)
+        {
+            size_t last = stationBays.size() * (lp + 1) / numProcesses;
+            std::vector<int> groupBays(stationBays.begin() + first, stationBays.begin() + last);
+            unsigned lpSeed = IsCounterBasedRng<Rng>::value ? seed : seed + lp;
+            processes.push_back(std::make_unique<LogicalProcess>(*this, lp, static_cast<int>(first), groupBays,
+                                                                 static_cast<int>(trucks.size()), lpSeed, timing));
+            firstBay.push_back(firstBay.back() + processes.back()->totalBays);
+            first = last;
+        }
+    }
+
+    void gather()
+    {
+        trucks.reset();
+        stations.clear();
+        for (const auto &process : processes)
+        {
+            const BasicTruckTable<Tick> &share = process->trucks;
+            for (size_t truckId = 0; truckId < trucks.size(); ++truckId)
+            {
+                trucks.loadsDelivered[truckId] += share.loadsDelivered[truckId];
+                trucks.totalWaitTime[truckId] += share.totalWaitTime[truckId];
+                trucks.totalTravelTime[truckId] += share.totalTravelTime[truckId];
+                trucks.totalMiningTime[truckId] += share.totalMiningTime[truckId];
+                trucks.totalUnloadTime[truckId] += share.totalUnloadTime[truckId];
+                if (share.stationId[truckId] != -1)
+                {
+                    trucks.arrivalEventTime[truckId] = share.arrivalEventTime[truckId];
+                    trucks.stationId[truckId] = process->firstStation + share.stationId[truckId];
+                    trucks.nextInQueue[truckId] = share.nextInQueue[truckId];
+                }
+            }
+            for (const Station &station : process->stations)
+            {
+                stations.push_back(station);
+                stations.back().id = process->firstStation + station.id;
+            }
+            stats += process->stats;
+        }
+    }
+};
+
+/*
+ * ================================
+ * BENCHMARKS
+ * ================================
+ * Run with `--bench`. Uses the classic "hold" workload: n events are pending,
+ * and each operation pops the earliest one and pushes it back at a
+ * real-valued exponential offset. This is the steady state of a fleet of
+ * n trucks. RadixEventQueue and PackedEventHeap round times to whole minutes.
+ */
+template <typename EventQueue>
+double benchmarkHold(int pending, int operations)
+{
+    // Pre-draw the offsets so the RNG stays out of the measurement
+    std::mt19937 rng(12345);
+    std::exponential_distribution<double> offsetDist(1.0 / 100.0);
+    std::vector<double> offsets(4096);
+    for (double &offset : offsets)
+    {
+        offset = offsetDist(rng);
+    }
+
+    EventQueue queue(pending);
+    for (int i = 0; i < pending; ++i)
+    {
+        queue.push(Event{offsets[i % offsets.size()] * (1 + i % 7), EventType::FINISH_MINING, 0, i});
+    }
+
+    // Warm up so the ladder reaches its steady-state shape
+    for (int i = 0; i < pending; ++i)
+    {
+        Event evt = queue.top();
+        queue.pop();
+        evt.time += offsets[i & 4095];
+        queue.push(evt);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < operations; ++i)
+    {
+        Event evt = queue.top();
+        queue.pop();
+        evt.time += offsets[i & 4095];
+        queue.push(evt);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / operations;
+}
+
+/*
+ * Steps a 20k-truck simulation in 10-minute windows; with `rescheduleEvery`
+ * set, every that-many-th truck gets its queued event delayed at each step.
+ * Returns nanoseconds per handled event.
+ */
+template <typename EventQueue>
+double benchmarkRescheduling(int rescheduleEvery, uint64_t &compactions)
+{
+    const int numTrucks = 20000;
+    Simulation<EventQueue> sim(numTrucks, 500, 99);
+    std::mt19937 rng(4);
+    std::uniform_int_distribution<int> delayDist(1, 10);
+
+    auto start = std::chrono::steady_clock::now();
+    sim.start();
+    for (int t = 10; t <= SIMULATION_TIME; t += 10)
+    {
+        sim.advance(t);
+        if (rescheduleEvery == 0)
+        {
+            continue;
+        }
+        for (int truckId = t % rescheduleEvery; truckId < numTrucks; truckId += rescheduleEvery)
+        {
+            sim.delayTruck(truckId, delayDist(rng));
+        }
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    compactions = sim.getCompactions();
+    return elapsed.count() / sim.getEventsProcessed();
+}
+
+template <typename EventQueue>
+void reportRescheduling(const char *name)
+{
+    uint64_t compactions = 0;
+    double baseline = benchmarkRescheduling<EventQueue>(0, compactions);
+    double rescheduled = benchmarkRescheduling<EventQueue>(20, compactions);
+    std::cout << std::setw(12) << name << std::fixed << std::setprecision(1) << std::setw(14) << baseline
+              << std::setw(14) << rescheduled << std::setw(14) << compactions << "\n";
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+}
+
+/*
+ * Result of one full benchmark run of a simulation configuration.
+ */
+struct RunResult
+{
+    double seconds;
+    uint64_t events;
+    double meanWait; // mean wait per delivered load (min)
+};
+
+template <typename Sim>
+RunResult benchmarkRun(int numTrucks, int numStations)
+{
+    auto start = std::chrono::steady_clock::now();
+    Sim sim(numTrucks, numStations, 2024);
+    sim.run();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    auto totals = sim.getTrucks().totals();
+    double meanWait =
+        totals.loadsDelivered > 0 ? static_cast<double>(totals.totalWaitTime) / totals.loadsDelivered : 0.0;
+    return RunResult{elapsed.count(), sim.getEventsProcessed(), meanWait};
+}
+
+void printRunResult(const char *name, int numStations, const RunResult &result)
+{
+    std::cout << std::setw(26) << name << std::setw(10) << numStations << std::fixed << std::setprecision(3)
+              << std::setw(12) << result.seconds << std::setw(12) << std::setprecision(2)
+              << result.events / result.seconds / 1e6 << std::setw(14) << result.meanWait << "\n";
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+}
+
+/*
+ * Nanoseconds per mining-time draw of an RNG policy, over `draws` draws
+ * spread across a fleet of 1024 trucks.
+ */
+template <typename Rng>
+double benchmarkDraws(int draws)
+{
+    Rng rng(2024);
+    int64_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < draws; ++i)
+    {
+        sum += rng.miningTime(i & 1023, i >> 10);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    volatile int64_t used = sum; // keeps the draws from being optimized away
+    (void)used;
+    return elapsed.count() * 1e9 / draws;
+}
+
+/*
+ * RNG policies on their own, then in a large fleet where the draw is on the
+ * FINISH_UNLOADING hot path.
+ */
+void runRngBenchmarks()
+{
+    const int draws = 20000000;
+    std::cout << "==== Benchmark: mining-time draws (ns per draw) ====\n";
+    std::cout << std::setw(22) << "MersenneTwister" << std::setw(14) << "Xoshiro128" << std::setw(14) << "Philox"
+              << std::setw(16) << "BufferedXoshiro" << "\n";
+    std::cout << std::fixed << std::setprecision(2) << std::setw(22) << benchmarkDraws<MersenneTwisterRng>(draws)
+              << std::setw(14) << benchmarkDraws<Xoshiro128Rng>(draws) << std::setw(14)
+              << benchmarkDraws<PhiloxRng>(draws) << std::setw(16) << benchmarkDraws<BufferedXoshiroRng>(draws)
+              << "\n\n";
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+
+    std::cout << "==== Benchmark: RNG policy in a full run (40 trucks per station) ====\n";
+    std::cout << std::setw(26) << "policy" << std::setw(10) << "stations" << std::setw(12) << "seconds"
+              << std::setw(12) << "Mevents/s" << std::setw(14) << "wait/load" << "\n";
+    const int numStations = 2048;
+    const int numTrucks = numStations * 40;
+    printRunResult("MersenneTwisterRng", numStations,
+                   benchmarkRun<Simulation<IndexedEventHeap, ProjectedFreeTimeSelection>>(numTrucks, numStations));
+    printRunResult("PhiloxRng", numStations,
+                   benchmarkRun<Simulation<IndexedEventHeap, ProjectedFreeTimeSelection, PhiloxRng>>(numTrucks,
+                                                                                                   numStations));
+    printRunResult("BufferedXoshiroRng", numStations,
+                   benchmarkRun<Simulation<IndexedEventHeap, ProjectedFreeTimeSelection, BufferedXoshiroRng>>(
+                       numTrucks, numStations));
+    std::cout << std::endl;
+}
+
+/*
+ * Station selection at sites with many unload bays: about 40 trucks per
+ * station keeps stations busy without saturating them.
+ */
+void runStationSelectionBenchmarks()
+{
+    std::cout << "==== Benchmark: station selection (40 trucks per station) ====\n";
+    std::cout << std::setw(26) << "policy" << std::setw(10) << "stations" << std::setw(12) << "seconds"
+              << std::setw(12) << "Mevents/s" << std::setw(14) << "wait/load" << "\n";
+    for (int numStations : {64, 512, 2048})
+    {
+        int numTrucks = numStations * 40;
+        printRunResult("ShortestQueue", numStations,
+                       benchmarkRun<Simulation<IndexedEventHeap, ShortestQueueSelection>>(numTrucks, numStations));
+        printRunResult("SimdShortestQueue", numStations,
+                       benchmarkRun<Simulation<IndexedEventHeap, SimdShortestQueueSelection>>(numTrucks, numStations));
+        printRunResult("ProjectedFreeTime", numStations,
+                       benchmarkRun<Simulation<IndexedEventHeap, ProjectedFreeTimeSelection>>(numTrucks, numStations));
+    }
+    std::cout << std::endl;
+}
+
+/*
+ * Power-of-d dispatch against exact join-shortest-queue (the SIMD scan makes
+ * the same choice as the plain scan, only faster). At the largest site exact
+ * JSQ is too slow to run, so the projected-free-time tree is the reference.
+ */
+void runPowerOfDBenchmarks()
+{
+    std::cout << "==== Benchmark: power-of-d dispatch (40 trucks per station) ====\n";
+    std::cout << std::setw(26) << "policy" << std::setw(10) << "stations" << std::setw(12) << "seconds"
+              << std::setw(12) << "Mevents/s" << std::setw(14) << "wait/load" << "\n";
+    for (int numStations : {1024, 4096, 16384})
+    {
+        int numTrucks = numStations * 40;
+        if (numStations <= 4096)
+        {
+            printRunResult("exact JSQ", numStations,
+                           benchmarkRun<Simulation<IndexedEventHeap, SimdShortestQueueSelection>>(numTrucks, numStations));
+        }
+        else
+        {
+            printRunResult("ProjectedFreeTime", numStations,
+                           benchmarkRun<Simulation<IndexedEventHeap, ProjectedFreeTimeSelection>>(numTrucks, numStations));
+        }
+        printRunResult("PowerOfDChoices<2>", numStations,
+                       benchmarkRun<Simulation<IndexedEventHeap, PowerOfDChoicesSelection<2>>>(numTrucks, numStations));
+        printRunResult("PowerOfDChoices<3>", numStations,
+                       benchmarkRun<Simulation<IndexedEventHeap, PowerOfDChoicesSelection<3>>>(numTrucks, numStations));
+        printRunResult("PowerOfDChoices<1>", numStations,
+                       benchmarkRun<Simulation<IndexedEventHeap, PowerOfDChoicesSelection<1>>>(numTrucks, numStations));
+    }
+    std::cout << std::endl;
+}
+
+/*
+ * Replication throughput as worker threads are added (1, 2, 4, ... up to every
+ * hardware thread). Each worker gets the same number of replications, so with
+ * linear scaling the time stays flat and replications/s doubles per step.
+ */
+void runReplicationBenchmarks()
+{
+    std::cout << "==== Benchmark: parallel replications (1000 trucks, 20 stations, 64 per thread) ====\n";
+    std::cout << std::setw(10) << "threads" << std::setw(12) << "seconds" << std::setw(14) << "runs/s"
+              << std::setw(12) << "speedup" << "\n";
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    double baseline = 0.0;
+    for (unsigned threads = 1;; threads = std::min(threads * 2, maxThreads))
+    {
+        ReplicationRunner<Simulation<>> runner(1000, 20, SimulationOptions(), SiteTiming(), threads);
+        int replications = 64 * static_cast<int>(threads);
+        auto start = std::chrono::steady_clock::now();
+        runner.run(replications, 1);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        double rate = replications / elapsed.count();
+        if (threads == 1)
+        {
+            baseline = rate;
+        }
+        std::cout << std::setw(10) << threads << std::setw(12) << std::fixed << std::setprecision(3)
+                  << elapsed.count() << std::setw(14) << std::setprecision(1) << rate << std::setw(12)
+                  << std::setprecision(2) << rate / baseline << "\n";
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+        if (threads == maxThreads)
+        {
+            break;
+        }
+    }
+    std::cout << std::endl;
+}
+
+void runLockstepBenchmarks()
+{
+    std::cout << "==== Benchmark: lockstep replications, " << LockstepReplications::LANES
+              << " lanes (replications per second) ====\n";
+    std::cout << std::setw(18) << "trucks/stations" << std::setw(14) << "one by one" << std::setw(14) << "lockstep"
+              << std::setw(12) << "speedup" << "\n";
+    const int replications = 4096;
+    const int scenarios[][2] = {{3, 1}, {5, 2}, {10, 3}};
+    for (const auto &scenario : scenarios)
+    {
+        int numTrucks = scenario[0];
+        int numStations = scenario[1];
+        using XoshiroSim = Simulation<IndexedEventHeap, ShortestQueueSelection, Xoshiro128Rng, int32_t>;
+        ReplicationRunner<XoshiroSim> runner(numTrucks, numStations, SimulationOptions(), SiteTiming(), 1);
+        auto start = std::chrono::steady_clock::now();
+        runner.run(replications, 1);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        double sequentialRate = replications / elapsed.count();
+
+        LockstepReplications lockstep(numTrucks, numStations);
+        start = std::chrono::steady_clock::now();
+        lockstep.run(replications, 1);
+        elapsed = std::chrono::steady_clock::now() - start;
+        double lockstepRate = replications / elapsed.count();
+
+        std::cout << std::setw(18) << (std::to_string(numTrucks) + " / " + std::to_string(numStations))
+                  << std::setw(14) << std::fixed << std::setprecision(0) << sequentialRate << std::setw(14)
+                  << lockstepRate << std::setw(12) << std::setprecision(2) << lockstepRate / sequentialRate << "\n";
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+    std::cout << std::endl;
+}
+
+/*
+ * Capacity decisions with common random numbers: the 95% CI of the change from
+ * adding a station, paired vs independent replications, and the variance
+ * reduction (replications saved) for each statistic.
+ */
+void runPairedComparisonBenchmarks()
+{
+    const int replications = 200;
+    std::cout << "==== Benchmark: paired comparison, one more station (" << replications
+              << " replications, difference +/- paired CI / unpaired CI) ====\n";
+    std::cout << std::setw(18) << "trucks/stations" << std::setw(32) << "loads delivered" << std::setw(32)
+              << "utilization %" << std::setw(32) << "wait/load (min)" << "\n";
+    auto printCell = [](const PairedStatistic &statistic) {
+        std::ostringstream cell;
+        cell << std::fixed << std::setprecision(2) << statistic.difference.mean() << " +/- "
+             << statistic.difference.halfWidth95() << " / " << statistic.unpairedHalfWidth95() << " ("
+             << std::setprecision(1) << statistic.varianceReduction() << "x)";
+        std::cout << std::setw(32) << cell.str();
+    };
+    PairedComparison<> comparison;
+    const int scenarios[][2] = {{5, 1}, {30, 1}, {80, 2}, {200, 4}};
+    for (const auto &scenario : scenarios)
+    {
+        SweepPoint baseline{scenario[0], scenario[1], SiteTiming()};
+        SweepPoint alternative{scenario[0], scenario[1] + 1, SiteTiming()};
+        PairedComparisonResult result = comparison.run(baseline, alternative, replications, 1);
+        std::cout << std::setw(18)
+                  << (std::to_string(scenario[0]) + " / " + std::to_string(scenario[1]) + "->" +
+                      std::to_string(scenario[1] + 1));
+        printCell(result.loadsDelivered);
+        printCell(result.utilization);
+        printCell(result.waitPerLoad);
+        std::cout << "\n";
+    }
+    std::cout << std::endl;
+}
+
+void runParallelEngineBenchmarks()
+{
+    const int numTrucks = 200000;
+    const int numStations = 4800;
+    std::cout << "==== Benchmark: conservative parallel engine (" << numTrucks << " trucks, " << numStations
+              << " stations) ====\n";
+    std::cout << std::setw(24) << "engine" << std::setw(12) << "seconds" << std::setw(12) << "Mevents/s"
+              << std::setw(12) << "speedup" << std::setw(14) << "wait/load" << "\n";
+    auto printRow = [](const std::string &name, double seconds, uint64_t events, double speedup, double waitPerLoad) {
+        std::cout << std::setw(24) << name << std::setw(12) << std::fixed << std::setprecision(3) << seconds
+                  << std::setw(12) << std::setprecision(2) << events / seconds / 1e6 << std::setw(12) << speedup
+                  << std::setw(14) << waitPerLoad << "\n";
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    };
+
+    SimulationOptions fused;
+    fused.fuseTruckCycle = true;
+    Simulation<IndexedEventHeap, ProjectedFreeTimeSelection> sequentialSim(numTrucks, numStations, 8, fused);
+    auto start = std::chrono::steady_clock::now();
+    sequentialSim.run();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double baseline = elapsed.count();
+    auto totals = sequentialSim.getTrucks().totals();
+    printRow("sequential (fused)", baseline, sequentialSim.getEventsProcessed(), 1.0,
+             static_cast<double>(totals.totalWaitTime) / totals.loadsDelivered);
+
+    // One LP per thread
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1;; threads = std::min(threads * 2, maxThreads))
+    {
+        ConservativeParallelSimulation<BinaryHeapEventQueue, ProjectedFreeTimeSelection> parallelSim(
+            numTrucks, numStations, 8, threads, threads);
+        start = std::chrono::steady_clock::now();
+        parallelSim.run();
+        elapsed = std::chrono::steady_clock::now() - start;
+        totals = parallelSim.getTrucks().totals();
+        printRow(std::to_string(threads) + " LPs / threads", elapsed.count(), parallelSim.getEventsProcessed(),
+                 baseline / elapsed.count(), static_cast<double>(totals.totalWaitTime) / totals.loadsDelivered);
+        if (threads == maxThreads)
+        {
+            break;
+        }
+    }
+    std::cout << std::endl;
+}
+
+void runOptimisticEngineBenchmarks()
+{
+    const int numTrucks = 200000;
+    const int numStations = 4800;
+    std::cout << "==== Benchmark: optimistic (Time Warp) engine (" << numTrucks << " trucks, " << numStations
+              << " stations) ====\n";
+    // Above one LP only the same LPs on one thread compute the same result
+    std::cout << "  vs seq*: speedup over the sequential run, a different dispatch model above 1 LP (see wait/load)\n"
+              << "  vs 1 thread: speedup over the same LPs on one thread, which give the identical result\n";
+    std::cout << std::setw(24) << "engine" << std::setw(12) << "seconds" << std::setw(12) << "vs seq*"
+              << std::setw(13) << "vs 1 thread" << std::setw(14) << "rollbacks" << std::setw(12) << "efficiency"
+              << std::setw(14) << "wait/load" << "\n";
+    auto printRow = [](const std::string &name, double seconds, double speedup, double sameModelSpeedup,
+                       double rollbackRate, double efficiency, double waitPerLoad) {
+        std::cout << std::setw(24) << name << std::setw(12) << std::fixed << std::setprecision(3) << seconds
+                  << std::setw(12) << std::setprecision(2) << speedup << std::setw(13) << sameModelSpeedup
+                  << std::setw(13) << rollbackRate * 100.0 << "%" << std::setw(12) << efficiency << std::setw(14)
+                  << waitPerLoad << "\n";
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    };
+
+    SimulationOptions fused;
+    fused.fuseTruckCycle = true;
+    Simulation<IndexedEventHeap, ProjectedFreeTimeSelection> sequentialSim(numTrucks, numStations, 8, fused);
+    auto start = std::chrono::steady_clock::now();
+    sequentialSim.run();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double baseline = elapsed.count();
+    auto totals = sequentialSim.getTrucks().totals();
+    printRow("sequential (fused)", baseline, 1.0, 1.0, 0.0, 1.0,
+             static_cast<double>(totals.totalWaitTime) / totals.loadsDelivered);
+
+    // One LP per thread
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1;; threads = std::min(threads * 2, maxThreads))
+    {
+        double oneThread = 0.0;
+        if (threads > 1)
+        {
+            TimeWarpSimulation<ProjectedFreeTimeSelection> serialSim(numTrucks, numStations, 8, threads, 1);
+            start = std::chrono::steady_clock::now();
+            serialSim.run();
+            elapsed = std::chrono::steady_clock::now() - start;
+            oneThread = elapsed.count();
+        }
+        TimeWarpSimulation<ProjectedFreeTimeSelection> optimisticSim(numTrucks, numStations, 8, threads, threads);
+        start = std::chrono::steady_clock::now();
+        optimisticSim.run();
+        elapsed = std::chrono::steady_clock::now() - start;
+        if (threads == 1)
+        {
+            oneThread = elapsed.count();
+        }
+        totals = optimisticSim.getTrucks().totals();
+        const TimeWarpStats &stats = optimisticSim.getStats();
+        printRow(std::to_string(threads) + " LPs / threads", elapsed.count(), baseline / elapsed.count(),
+                 oneThread / elapsed.count(), stats.rollbackRate(), stats.efficiency(),
+                 static_cast<double>(totals.totalWaitTime) / totals.loadsDelivered);
+        if (threads == maxThreads)
+        {
+            break;
+        }
+    }
+    std::cout << std::endl;
+}
+
+void runEventQueueBenchmarks()
+{
+    std::cout << "==== Benchmark: event queue hold model (ns per pop+push) ====\n";
+    std::cout << std::setw(10) << "pending" << std::setw(14) << "BinaryHeap" << std::setw(14) << "Indexed"
+              << std::setw(14) << "Ladder" << std::setw(14) << "Radix" << std::setw(14) << "Packed" << "\n";
+    for (int pending : {1000, 10000, 100000, 1000000, 4000000})
+    {
+        const int operations = 4000000;
+        std::cout << std::setw(10) << pending << std::fixed << std::setprecision(1)
+                  << std::setw(14) << benchmarkHold<BinaryHeapEventQueue>(pending, operations)
+                  << std::setw(14) << benchmarkHold<IndexedEventHeap>(pending, operations)
+                  << std::setw(14) << benchmarkHold<LadderEventQueue>(pending, operations)
+                  << std::setw(14) << benchmarkHold<RadixEventQueue>(pending, operations)
+                  << std::setw(14) << benchmarkHold<PackedEventHeap>(pending, operations) << "\n";
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+    std::cout << std::endl;
+
+    std::cout << "==== Benchmark: cancellation, 5% of trucks delayed every 10 min (ns per event) ====\n";
+    std::cout << std::setw(12) << "engine" << std::setw(14) << "baseline" << std::setw(14) << "rescheduled"
+              << std::setw(14) << "compactions" << "\n";
+    reportRescheduling<BinaryHeapEventQueue>("BinaryHeap");
+    reportRescheduling<IndexedEventHeap>("Indexed");
+    reportRescheduling<LadderEventQueue>("Ladder");
+    reportRescheduling<RadixEventQueue>("Radix");
+    std::cout << std::endl;
+}
+
+/*
+ * Test helper: true if both runs produced exactly the same per-truck statistics.
+ */
+template <typename SimA, typename SimB>
+bool sameTruckStatistics(const SimA &a, const SimB &b)
+{
+    if (a.getTrucks().size() != b.getTrucks().size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.getTrucks().size(); ++i)
+    {
+        const Truck &x = a.getTrucks()[i];
+        const Truck &y = b.getTrucks()[i];
+        if (x.loadsDelivered != y.loadsDelivered || x.totalWaitTime != y.totalWaitTime ||
+            x.totalTravelTime != y.totalTravelTime || x.totalMiningTime != y.totalMiningTime ||
+            x.totalUnloadTime != y.totalUnloadTime)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * True if two replication summaries hold exactly the same sums.
+ */
+bool sameSummary(const ReplicationSummary &a, const ReplicationSummary &b)
+{
+    auto same = [](const SampleMoments &x, const SampleMoments &y) {
+        return x.count == y.count && x.sum == y.sum && x.sumSquares == y.sumSquares;
+    };
+    if (a.loadsDelivered.size() != b.loadsDelivered.size() || a.stationBusyTime.size() != b.stationBusyTime.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.loadsDelivered.size(); ++i)
+    {
+        if (!same(a.loadsDelivered[i], b.loadsDelivered[i]) || !same(a.waitTime[i], b.waitTime[i]) ||
+            !same(a.travelTime[i], b.travelTime[i]) || !same(a.miningTime[i], b.miningTime[i]) ||
+            !same(a.unloadTime[i], b.unloadTime[i]))
+        {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < a.stationBusyTime.size(); ++i)
+    {
+        if (!same(a.stationBusyTime[i], b.stationBusyTime[i]))
+        {
+            return false;
+        }
+    }
+    return same(a.fleetLoads, b.fleetLoads) && same(a.fleetWaitTime, b.fleetWaitTime);
+}
+
+/*
+ * True if every truck's mining time is the sum of the PhiloxRng draws for its
+ * cycles 1..loadsDelivered (the first mining run, cycle 0, is not counted), that
+ * is, if the draws did not depend on the order events were handled in.
+ */
+template <typename Sim>
+bool miningFollowsCycles(const Sim &sim, unsigned seed)
+{
+    PhiloxRng rng(seed);
+    for (const Truck &truck : sim.getTrucks())
+    {
+        double expected = 0.0;
+        for (int cycle = 1; cycle <= truck.loadsDelivered; ++cycle)
+        {
+            expected += rng.miningTime(truck.id, cycle);
+        }
+        if (truck.totalMiningTime != expected)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Runs a simulation with one seed, resets it to another and runs it again;
+ * the second run must match a new simulation built with that seed.
+ */
+template <typename Sim>
+bool resetMatchesFresh(int numTrucks, int numStations, SimulationOptions options = SimulationOptions())
+{
+    Sim reusedSim(numTrucks, numStations, 1, options);
+    reusedSim.run();
+    reusedSim.reset(2);
+    reusedSim.run();
+
+    Sim freshSim(numTrucks, numStations, 2, options);
+    freshSim.run();
+    return sameTruckStatistics(reusedSim, freshSim) &&
+           reusedSim.getEventsProcessed() == freshSim.getEventsProcessed();
+}
+
+/*
+ * ================================
+ * MAIN: Test Cases
+ * ================================
+ *
+ * if more time, would add test cases to each function
+ *
+ * using debugger to manually verifiy functionality
+ */
+int main(int argc, char **argv)
+{
+    // `simulation --bench` runs the benchmarks instead of the test cases
+    if (argc > 1 && std::string(argv[1]) == "--bench")
+    {
+        runEventQueueBenchmarks();
+        runStationSelectionBenchmarks();
+        runPowerOfDBenchmarks();
+        runRngBenchmarks();
+        runReplicationBenchmarks();
+        runLockstepBenchmarks();
+        runPairedComparisonBenchmarks();
+        runParallelEngineBenchmarks();
+        runOptimisticEngineBenchmarks();
+        return 0;
+    }
+
+    // test class 0: General tests
+    //  Test 0.1: 3 trucks, 1 station
+    {
+        std::cout << "==== Test Case 0.1: 3 Trucks, 1 Station ====\n";
+        Simulation sim(3, 1);
+        sim.run();
+        sim.printStats();
+    }
+
+    // Test 0.2: 5 trucks, 2 stations
+    {
+        std::cout << "==== Test Case 0.2: 5 Trucks, 2 Stations ====\n";
         Simulation sim(5, 2);
         sim.run();
         sim.printStats();
@@ -479,5 +5842,855 @@ int main()
         sim.run();
         sim.printStats();
     }
+
+    // Test class 3: alternative event-queue engines
+    // Test 3.1: radix heap must replay the indexed heap exactly for the same seed
+    {
+        std::cout << "==== Test Case 3.1: RadixEventQueue vs IndexedEventHeap, 50 Trucks, 3 Stations ====\n";
+        Simulation<IndexedEventHeap> heapSim(50, 3, 42);
+        Simulation<RadixEventQueue> radixSim(50, 3, 42);
+        heapSim.run();
+        radixSim.run();
+
+        bool same = sameTruckStatistics(heapSim, radixSim);
+        std::cout << (same ? "  PASS" : "  FAIL") << ": identical truck statistics\n\n";
+    }
+
+    // Test 3.2: ladder queue must also replay the indexed heap exactly
+    {
+        std::cout << "==== Test Case 3.2: LadderEventQueue vs IndexedEventHeap, 500 Trucks, 12 Stations ====\n";
+        Simulation<IndexedEventHeap> heapSim(500, 12, 7);
+        Simulation<LadderEventQueue> ladderSim(500, 12, 7);
+        heapSim.run();
+        ladderSim.run();
+
+        bool same = sameTruckStatistics(heapSim, ladderSim) && heapSim.getEventsProcessed() == ladderSim.getEventsProcessed();
+        std::cout << (same ? "  PASS" : "  FAIL") << ": identical truck statistics\n\n";
+    }
+
+    // Test 3.3: packed 8-byte events must also replay the indexed heap exactly
+    {
+        std::cout << "==== Test Case 3.3: PackedEventHeap vs IndexedEventHeap, 500 Trucks, 12 Stations ====\n";
+        Simulation<IndexedEventHeap> heapSim(500, 12, 3);
+        Simulation<PackedEventHeap> packedSim(500, 12, 3);
+        heapSim.run();
+        packedSim.run();
+
+        bool same = sameTruckStatistics(heapSim, packedSim);
+        std::cout << (same ? "  PASS" : "  FAIL") << ": identical truck statistics\n\n";
+    }
+
+    // Test 3.4: cancelling and immediately re-queuing every truck's event must not
+    // change anything, whichever engine holds the stale entries
+    {
+        std::cout << "==== Test Case 3.4: cancel + reschedule with zero delay, 500 Trucks, 12 Stations ====\n";
+        Simulation<> plainSim(500, 12, 8);
+        Simulation<BinaryHeapEventQueue> heapSim(500, 12, 8);
+        Simulation<LadderEventQueue> ladderSim(500, 12, 8);
+        Simulation<RadixEventQueue> radixSim(500, 12, 8);
+        plainSim.run();
+        heapSim.start();
+        ladderSim.start();
+        radixSim.start();
+        for (int t = 500; t <= SIMULATION_TIME; t += 500)
+        {
+            heapSim.advance(t);
+            ladderSim.advance(t);
+            radixSim.advance(t);
+            for (int truckId = 0; truckId < 500; ++truckId)
+            {
+                heapSim.delayTruck(truckId, 0);
+                ladderSim.delayTruck(truckId, 0);
+                radixSim.delayTruck(truckId, 0);
+            }
+        }
+        heapSim.advance(SIMULATION_TIME);
+        ladderSim.advance(SIMULATION_TIME);
+        radixSim.advance(SIMULATION_TIME);
+
+        bool same = sameTruckStatistics(plainSim, heapSim) && sameTruckStatistics(plainSim, ladderSim) &&
+                    sameTruckStatistics(plainSim, radixSim);
+        std::cout << (same ? "  PASS" : "  FAIL") << ": identical truck statistics ("
+                  << heapSim.getCompactions() << " compactions)\n\n";
+    }
+
+    // Test 3.5: nonzero delays on the default IndexedEventHeap. Waiting and
+    // unloading trucks must be refused (an unloading truck holds its bay), the
+    // overwritten entries must not count as stale (no compactions), and every
+    // station's busy time must still match the unloads booked on the trucks.
+    {
+        std::cout << "==== Test Case 3.5: delay by 7 min on IndexedEventHeap, 500 Trucks, 12 Stations ====\n";
+        Simulation<> sim(500, 12, 8);
+        sim.start();
+        bool refusedAtStations = true;
+        int delayed = 0;
+        for (int t = 250; t <= SIMULATION_TIME; t += 250)
+        {
+            sim.advance(t);
+            for (int truckId = 0; truckId < 500; ++truckId)
+            {
+                bool atStation = sim.getTrucks().stationId[truckId] != -1;
+                bool accepted = sim.delayTruck(truckId, 7);
+                refusedAtStations = refusedAtStations && accepted != atStation;
+                delayed += accepted ? 1 : 0;
+            }
+        }
+        sim.advance(SIMULATION_TIME);
+
+        bool unloadsBooked = true;
+        double unloadTime = 0.0;
+        for (const Truck &truck : sim.getTrucks())
+        {
+            double unfinished = truck.totalUnloadTime - UNLOAD_TIME * truck.loadsDelivered;
+            unloadsBooked = unloadsBooked && (unfinished == 0.0 || unfinished == UNLOAD_TIME);
+            unloadTime += truck.totalUnloadTime;
+        }
+        double busyTime = 0.0;
+        for (const Station &station : sim.getStations())
+        {
+            busyTime += station.totalBusyTime;
+        }
+        // Only unloads still running at the end are clipped, at most one per bay
+        unloadsBooked = unloadsBooked && busyTime <= unloadTime && busyTime >= unloadTime - 12 * UNLOAD_TIME;
+        bool pass = refusedAtStations && unloadsBooked && sim.getCompactions() == 0 && delayed > 0;
+        std::cout << (pass ? "  PASS" : "  FAIL") << ": " << delayed << " delays, station trucks refused, "
+                  << sim.getCompactions() << " compactions\n\n";
+    }
+
+    // Test class 4: engine modes
+    // Test 4.1: fused truck cycle must match the plain event sequence with fewer events
+    {
+        std::cout << "==== Test Case 4.1: fuseTruckCycle, 50 Trucks, 3 Stations ====\n";
+        SimulationOptions fused;
+        fused.fuseTruckCycle = true;
+        Simulation<> plainSim(50, 3, 11);
+        Simulation<> fusedSim(50, 3, 11, fused);
+        plainSim.run();
+        fusedSim.run();
+
+        bool same = sameTruckStatistics(plainSim, fusedSim);
+        std::cout << (same ? "  PASS" : "  FAIL") << ": identical truck statistics\n"
+                  << "  Events: " << plainSim.getEventsProcessed() << " -> " << fusedSim.getEventsProcessed() << "\n\n";
+    }
+
+    // Test 4.2: batched same-minute dispatch only reorders ties, so the fleet
+    // should deliver about the same number of loads as the default order
+    {
+        std::cout << "==== Test Case 4.2: batchSameTime, 1000 Trucks, 40 Stations ====\n";
+        SimulationOptions batched;
+        batched.batchSameTime = true;
+        Simulation<> plainSim(1000, 40, 5);
+        Simulation<> batchSim(1000, 40, 5, batched);
+        plainSim.run();
+        batchSim.run();
+
+        long plainLoads = 0;
+        long batchLoads = 0;
+        for (size_t i = 0; i < plainSim.getTrucks().size(); ++i)
+        {
+            plainLoads += plainSim.getTrucks()[i].loadsDelivered;
+            batchLoads += batchSim.getTrucks()[i].loadsDelivered;
+        }
+        bool close = std::abs(plainLoads - batchLoads) <= plainLoads / 100;
+        std::cout << (close ? "  PASS" : "  FAIL") << ": loads delivered " << plainLoads << " vs " << batchLoads << "\n\n";
+    }
+
+    // Test class 5: station selection policies
+    // Test 5.1: projected free time accounts for partially finished unloads, so
+    // over 20 replications it must not make trucks wait longer on average than
+    // queue length does: the mean paired difference in total wait may exceed 0
+    // by no more than its 95% CI half-width.
+    {
+        std::cout << "==== Test Case 5.1: ProjectedFreeTimeSelection vs ShortestQueueSelection, 20 Replications, 100 Trucks, 3 Stations ====\n";
+        Simulation<IndexedEventHeap, ShortestQueueSelection> queueSim(100, 3, 1);
+        Simulation<IndexedEventHeap, ProjectedFreeTimeSelection> freeTimeSim(100, 3, 1);
+        SampleMoments queueWait;
+        SampleMoments freeTimeWait;
+        SampleMoments difference;
+        for (unsigned seed = 1; seed <= 20; ++seed)
+        {
+            queueSim.reset(seed);
+            freeTimeSim.reset(seed);
+            queueSim.run();
+            freeTimeSim.run();
+            double queueTotal = static_cast<double>(queueSim.getTrucks().totals().totalWaitTime);
+            double freeTimeTotal = static_cast<double>(freeTimeSim.getTrucks().totals().totalWaitTime);
+            queueWait.add(queueTotal);
+            freeTimeWait.add(freeTimeTotal);
+            difference.add(freeTimeTotal - queueTotal);
+        }
+        bool pass = difference.mean() <= difference.halfWidth95();
+        std::cout << (pass ? "  PASS" : "  FAIL") << ": mean total wait " << queueWait.mean() << " -> "
+                  << freeTimeWait.mean() << " min (difference " << difference.mean() << " +/- "
+                  << difference.halfWidth95() << ")\n\n";
+    }
+
+    // Test 5.2: the SIMD queue-length table must pick exactly what the scan picks
+    {
+        std::cout << "==== Test Case 5.2: SimdShortestQueueSelection vs ShortestQueueSelection, 2000 Trucks, 45 Stations ====\n";
+        Simulation<IndexedEventHeap, ShortestQueueSelection> scanSim(2000, 45, 6);
+        Simulation<IndexedEventHeap, SimdShortestQueueSelection> simdSim(2000, 45, 6);
+        scanSim.run();
+        simdSim.run();
+
+        bool same = sameTruckStatistics(scanSim, simdSim);
+        std::cout << (same ? "  PASS" : "  FAIL") << ": identical truck statistics\n\n";
+    }
+
+    // Test 5.3: sampling two stations only costs some waiting, not throughput
+    {
+        std::cout << "==== Test Case 5.3: PowerOfDChoicesSelection<2> vs ShortestQueueSelection, 1500 Trucks, 45 Stations ====\n";
+        Simulation<IndexedEventHeap, ShortestQueueSelection> exactSim(1500, 45, 9);
+        Simulation<IndexedEventHeap, PowerOfDChoicesSelection<2>> sampledSim(1500, 45, 9);
+        exactSim.run();
+        sampledSim.run();
+
+        long exactLoads = 0;
+        long sampledLoads = 0;
+        double exactWait = 0.0;
+        double sampledWait = 0.0;
+        for (size_t i = 0; i < exactSim.getTrucks().size(); ++i)
+        {
+            exactLoads += exactSim.getTrucks()[i].loadsDelivered;
+            sampledLoads += sampledSim.getTrucks()[i].loadsDelivered;
+            exactWait += exactSim.getTrucks()[i].totalWaitTime;
+            sampledWait += sampledSim.getTrucks()[i].totalWaitTime;
+        }
+        bool close = std::abs(exactLoads - sampledLoads) <= exactLoads / 100;
+        std::cout << (close ? "  PASS" : "  FAIL") << ": loads delivered " << exactLoads << " vs " << sampledLoads
+                  << ", total wait " << exactWait << " vs " << sampledWait << " min\n\n";
+    }
+
+    /*
+     * ================================
+     * Test Case Class 6: multi-bay stations
+     * ================================
+     */
+
+    // Test Case 6.1: one station with 3 bays against 3 single-bay stations. The
+    // shared queue never leaves a bay idle while a truck waits, so over 20
+    // replications trucks must not wait longer on average (the mean paired
+    // difference may exceed 0 by no more than its 95% CI half-width), and each
+    // bay's busy time must add up to the station's.
+    {
+        std::cout << "==== Test Case 6.1: 1 Station x 3 Bays vs 3 Stations x 1 Bay, 20 Replications, 120 Trucks ====\n";
+        Simulation<> separateSim(120, 3, 1);
+        Simulation<> pooledSim(120, std::vector<int>{3}, 1);
+        SampleMoments separateWait;
+        SampleMoments pooledWait;
+        SampleMoments difference;
+        bool baysValid = true;
+        for (unsigned seed = 1; seed <= 20; ++seed)
+        {
+            separateSim.reset(seed);
+            pooledSim.reset(seed);
+            separateSim.run();
+            pooledSim.run();
+            double separateTotal = static_cast<double>(separateSim.getTrucks().totals().totalWaitTime);
+            double pooledTotal = static_cast<double>(pooledSim.getTrucks().totals().totalWaitTime);
+            separateWait.add(separateTotal);
+            pooledWait.add(pooledTotal);
+            difference.add(pooledTotal - separateTotal);
+
+            const Station &pooled = pooledSim.getStations()[0];
+            double bayTotal = 0.0;
+            for (double busy : pooled.bayBusyTime)
+            {
+                bayTotal += busy;
+                baysValid = baysValid && busy <= SIMULATION_TIME;
+            }
+            baysValid = baysValid && bayTotal == pooled.totalBusyTime;
+        }
+        bool pass = baysValid && difference.mean() <= difference.halfWidth95();
+        std::cout << (pass ? "  PASS" : "  FAIL") << ": mean total wait " << separateWait.mean() << " -> "
+                  << pooledWait.mean() << " min (difference " << difference.mean() << " +/- "
+                  << difference.halfWidth95() << ")\n";
+        pooledSim.getStations()[0].printStats();
+    }
+
+    /*
+     * ================================
+     * Test Case Class 7: integer-tick statistics
+     * ================================
+     */
+
+    // Test Case 7.1: int32_t counters must give the same statistics as doubles,
+    // and fleet totals summed in 64 bits must match the double totals exactly
+    {
+        std::cout << "==== Test Case 7.1: int32_t vs double statistics, 500 Trucks, 12 Stations ====\n";
+        Simulation<> doubleSim(500, 12, 8);
+        Simulation<IndexedEventHeap, ShortestQueueSelection, MersenneTwisterRng, int32_t> tickSim(500, 12, 8);
+        doubleSim.run();
+        tickSim.run();
+
+        FleetTotals<double> doubleTotals = doubleSim.getTrucks().totals();
+        FleetTotals<int64_t> tickTotals = tickSim.getTrucks().totals();
+        bool sameTotals = tickTotals.loadsDelivered == doubleTotals.loadsDelivered &&
+                          tickTotals.totalWaitTime == doubleTotals.totalWaitTime &&
+                          tickTotals.totalTravelTime == doubleTotals.totalTravelTime &&
+                          tickTotals.totalMiningTime == doubleTotals.totalMiningTime &&
+                          tickTotals.totalUnloadTime == doubleTotals.totalUnloadTime;
+        std::cout << (sameTruckStatistics(doubleSim, tickSim) && sameTotals ? "  PASS" : "  FAIL")
+                  << ": identical truck statistics, total wait " << tickTotals.totalWaitTime << " min\n\n";
+    }
+
+    /*
+     * ================================
+     * Test Case Class 8: reusing a simulation with reset()
+     * ================================
+     */
+
+    // Test Case 8.1: reset() must reuse every buffer; after the first run,
+    // reset() + run() allocates nothing, with single-bay stations and with
+    // multi-bay stations batched by time, where the zero-delay FIFO can hold one
+    // START_UNLOADING per bay
+    {
+        std::cout << "==== Test Case 8.1: reset() + run() after a first run, 500 Trucks, 12 Stations ====\n";
+        std::vector<int> multiBay = {4, 1, 3, 2, 4, 1, 2, 3, 1, 4, 2, 3};
+        Simulation<> reusedSim(500, 12, 1);
+        SimulationOptions batched;
+        batched.batchSameTime = true;
+        Simulation<> reusedMultiBaySim(500, multiBay, 1, batched);
+        reusedSim.run();
+        reusedMultiBaySim.run();
+
+        uint64_t before = allocationCount();
+        reusedSim.reset(2);
+        reusedSim.run();
+        reusedMultiBaySim.reset(2);
+        reusedMultiBaySim.run();
+        uint64_t allocations = allocationCount() - before;
+
+        Simulation<> freshSim(500, 12, 2);
+        Simulation<> freshMultiBaySim(500, multiBay, 2, batched);
+        freshSim.run();
+        freshMultiBaySim.run();
+        bool same = sameTruckStatistics(reusedSim, freshSim) && sameTruckStatistics(reusedMultiBaySim, freshMultiBaySim);
+        std::cout << (same && allocations == 0 ? "  PASS" : "  FAIL")
+                  << ": identical truck statistics, " << allocations << " allocations";
+#ifndef SIMULATION_COUNT_ALLOCATIONS
+        std::cout << " (not counted; build with -DSIMULATION_COUNT_ALLOCATIONS)";
+#endif
+        std::cout << "\n\n";
+    }
+
+    // Test Case 8.2: every engine and mode starts over cleanly
+    {
+        std::cout << "==== Test Case 8.2: reset() for every engine, 500 Trucks, 12 Stations ====\n";
+        SimulationOptions fused;
+        fused.fuseTruckCycle = true;
+        SimulationOptions batched;
+        batched.batchSameTime = true;
+        bool allMatch = resetMatchesFresh<Simulation<RadixEventQueue, ProjectedFreeTimeSelection>>(500, 12) &&
+                        resetMatchesFresh<Simulation<LadderEventQueue, PowerOfDChoicesSelection<2>>>(500, 12) &&
+                        resetMatchesFresh<Simulation<PackedEventHeap, SimdShortestQueueSelection>>(500, 12) &&
+                        resetMatchesFresh<Simulation<BinaryHeapEventQueue>>(500, 12, fused) &&
+                        resetMatchesFresh<Simulation<>>(500, 12, batched);
+        std::cout << (allMatch ? "  PASS" : "  FAIL") << ": identical truck statistics\n\n";
+    }
+
+    /*
+     * ================================
+     * Test Case Class 9: parallel replications
+     * ================================
+     */
+
+    // Test Case 9.1: the merged summary must not depend on the number of
+    // threads, and must match running the same seeds one after another
+    {
+        std::cout << "==== Test Case 9.1: ReplicationRunner, 1 vs 4 threads, 20 Replications, 50 Trucks, 3 Stations ====\n";
+        ReplicationRunner<Simulation<>> serialRunner(50, 3, SimulationOptions(), SiteTiming(), 1);
+        ReplicationRunner<Simulation<>> parallelRunner(50, 3, SimulationOptions(), SiteTiming(), 4);
+        ReplicationSummary serial = serialRunner.run(20, 100);
+        ReplicationSummary parallel = parallelRunner.run(20, 100);
+
+        SampleMoments expectedLoads;
+        for (unsigned seed = 100; seed < 120; ++seed)
+        {
+            Simulation<> sim(50, 3, seed);
+            sim.run();
+            expectedLoads.add(static_cast<double>(sim.getTrucks().totals().loadsDelivered));
+        }
+        bool matches = sameSummary(serial, parallel) && serial.fleetLoads.sum == expectedLoads.sum &&
+                       serial.fleetLoads.sumSquares == expectedLoads.sumSquares;
+        std::cout << (matches ? "  PASS" : "  FAIL") << ": loads delivered " << parallel.fleetLoads.mean()
+                  << " +/- " << parallel.fleetLoads.halfWidth95() << " per run\n";
+        std::cout << "  Station 0 utilization: " << parallel.utilization(0) << " %\n\n";
+    }
+
+    // Test Case 9.2: a bad scenario must be refused when the runner is built,
+    // and an exception in a worker thread must reach the caller once every
+    // worker has finished, instead of terminating the process
+    {
+        std::cout << "==== Test Case 9.2: ReplicationRunner rejects bad scenarios, worker exceptions reach the caller ====\n";
+        SiteTiming instant;
+        instant.miningTimeMin = 0;
+        instant.miningTimeMax = 0;
+        instant.travelTime = 0;
+        instant.unloadTime = 0;
+        int rejected = 0;
+        try
+        {
+            ReplicationRunner<Simulation<>> runner(10, 2, SimulationOptions(), instant, 2);
+        }
+        catch (const std::invalid_argument &)
+        {
+            ++rejected;
+        }
+        try
+        {
+            ReplicationRunner<Simulation<>> runner(10, std::vector<int>{1, -1}, SimulationOptions(), SiteTiming(), 2);
+        }
+        catch (const std::invalid_argument &)
+        {
+            ++rejected;
+        }
+
+        std::atomic<int> finished(0);
+        bool forwarded = false;
+        try
+        {
+            runWorkers(4, [&](unsigned worker) {
+                if (worker == 2)
+                {
+                    throw std::runtime_error("worker failed");
+                }
+                ++finished;
+            });
+        }
+        catch (const std::runtime_error &)
+        {
+            forwarded = true;
+        }
+        bool pass = rejected == 2 && forwarded && finished.load() == 3;
+        std::cout << (pass ? "  PASS" : "  FAIL") << ": " << rejected << " bad scenarios rejected, worker exception "
+                  << (forwarded ? "rethrown" : "lost") << " after " << finished.load() << " other workers\n\n";
+    }
+
+    /*
+     * ================================
+     * Test Case Class 10: parameter sweeps
+     * ================================
+     */
+
+    // Test Case 10.1: a sweep over trucks x stations x unload time must report
+    // every point once and match running each point's seeds directly
+    {
+        std::cout << "==== Test Case 10.1: SweepEngine, 3 x 2 x 2 Grid, 4 Replications, 3 Threads ====\n";
+        SiteTiming slowUnload;
+        slowUnload.unloadTime = 10;
+        std::vector<SweepPoint> points =
+            SweepEngine<Simulation<>>::grid({10, 50, 200}, {1, 3}, {SiteTiming(), slowUnload});
+
+        int streamed = 0;
+        SweepEngine<Simulation<>> engine(SimulationOptions(), 3);
+        SweepResult::printHeader();
+        std::vector<SweepResult> results = engine.run(points, 4, 100, [&](const SweepResult &result) {
+            ++streamed;
+            result.printRow();
+        });
+
+        bool matches = streamed == static_cast<int>(points.size());
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            double loads = 0.0;
+            for (unsigned seed = 100; seed < 104; ++seed)
+            {
+                Simulation<> sim(points[i].numTrucks, points[i].numStations, seed, SimulationOptions(),
+                                 points[i].timing);
+                sim.run();
+                loads += static_cast<double>(sim.getTrucks().totals().loadsDelivered);
+            }
+            matches = matches && results[i].point.numTrucks == points[i].numTrucks &&
+                      results[i].loadsDelivered.sum == loads;
+        }
+        std::cout << (matches ? "  PASS" : "  FAIL") << ": " << streamed
+                  << " points streamed, loads match direct runs\n\n";
+    }
+
+    // Test Case 10.2: a zero-length cycle would never advance the clock, so a
+    // sweep point (or any engine) with one must be refused up front, with an
+    // exception the caller can catch
+    {
+        std::cout << "==== Test Case 10.2: SiteTiming with a zero-length cycle is rejected ====\n";
+        SiteTiming instant;
+        instant.miningTimeMin = 0;
+        instant.miningTimeMax = 0;
+        instant.travelTime = 0;
+        instant.unloadTime = 0;
+        SiteTiming unloadOnly = instant;
+        unloadOnly.unloadTime = 1;
+
+        bool rejected = false;
+        try
+        {
+            Simulation<> sim(10, 2, 1, SimulationOptions(), instant);
+        }
+        catch (const std::invalid_argument &)
+        {
+            rejected = true;
+        }
+        bool sweepRejected = false;
+        try
+        {
+            SweepEngine<Simulation<>> engine(SimulationOptions(), 2);
+            engine.run({SweepPoint{10, 2, SiteTiming()}, SweepPoint{10, 2, instant}}, 2, 1);
+        }
+        catch (const std::invalid_argument &)
+        {
+            sweepRejected = true;
+        }
+        bool pass = rejected && sweepRejected && !instant.valid() && unloadOnly.valid();
+        std::cout << (pass ? "  PASS" : "  FAIL") << ": all-zero timing rejected by Simulation and SweepEngine, "
+                  << "1-minute cycle accepted\n\n";
+    }
+
+    /*
+     * ================================
+     * Test Case Class 11: conservative parallel engine
+     * ================================
+     */
+
+    // Test Case 11.1: with a single LP nothing is routed, so the windowed run
+    // must be exactly the sequential fused run
+    {
+        std::cout << "==== Test Case 11.1: parallel engine, 1 LP vs fused Simulation, 500 Trucks, 12 Stations ====\n";
+        SimulationOptions fused;
+        fused.fuseTruckCycle = true;
+        Simulation<> sequentialSim(500, 12, 5, fused);
+        ConservativeParallelSimulation<> parallelSim(500, 12, 5, 1);
+        sequentialSim.run();
+        parallelSim.run();
+        std::cout << (sameTruckStatistics(sequentialSim, parallelSim) ? "  PASS" : "  FAIL")
+                  << ": identical truck statistics\n\n";
+    }
+
+    // Test Case 11.2: with 8 LPs the result must not depend on the thread count,
+    // and must deliver about as many loads as the sequential engine with trucks
+    // waiting at most 30% longer per load
+    {
+        std::cout << "==== Test Case 11.2: parallel engine, 8 LPs on 1 vs 4 Threads, 4000 Trucks, 96 Stations ====\n";
+        Simulation<> sequentialSim(4000, 96, 6);
+        ConservativeParallelSimulation<> oneThreadSim(4000, 96, 6, 8, 1);
+        ConservativeParallelSimulation<> fourThreadSim(4000, 96, 6, 8, 4);
+        sequentialSim.run();
+        oneThreadSim.run();
+        fourThreadSim.run();
+
+        auto sequentialTotals = sequentialSim.getTrucks().totals();
+        auto parallelTotals = fourThreadSim.getTrucks().totals();
+        double sequentialWait = static_cast<double>(sequentialTotals.totalWaitTime) / sequentialTotals.loadsDelivered;
+        double parallelWait = static_cast<double>(parallelTotals.totalWaitTime) / parallelTotals.loadsDelivered;
+        bool close = std::abs(parallelTotals.loadsDelivered - sequentialTotals.loadsDelivered) <=
+                         sequentialTotals.loadsDelivered / 50 &&
+                     parallelWait <= 1.3 * sequentialWait;
+        std::cout << (sameTruckStatistics(oneThreadSim, fourThreadSim) && close ? "  PASS" : "  FAIL")
+                  << ": loads delivered " << sequentialTotals.loadsDelivered << " vs " << parallelTotals.loadsDelivered
+                  << ", wait per load " << sequentialWait << " vs " << parallelWait << " min\n\n";
+    }
+    /*
+     * ================================
+     * Test Case Class 12: optimistic (Time Warp) engine
+     * ================================
+     */
+
+    // Test Case 12.1: with a single LP there are no messages, so the optimistic
+    // run must be exactly the sequential fused run
+    {
+        std::cout << "==== Test Case 12.1: Time Warp engine, 1 LP vs fused Simulation, 500 Trucks, 12 Stations ====\n";
+        SimulationOptions fused;
+        fused.fuseTruckCycle = true;
+        Simulation<> sequentialSim(500, 12, 5, fused);
+        TimeWarpSimulation<> optimisticSim(500, 12, 5, 1);
+        sequentialSim.run();
+        optimisticSim.run();
+        bool same = sameTruckStatistics(sequentialSim, optimisticSim) &&
+                    sequentialSim.getEventsProcessed() == optimisticSim.getEventsProcessed();
+        std::cout << (same ? "  PASS" : "  FAIL") << ": identical truck statistics\n\n";
+    }
+
+    // Test Case 12.2: with 8 LPs, one thread running 1024 events per LP per round
+    // runs far ahead and rolls back often; after rollbacks the result must be the
+    // same as 4 threads with short rounds, deliver about as many loads as the
+    // sequential engine, and, dispatching to LPs at random, wait more per load
+    // than the sequential engine but no more than 7x (about 5.3x measured, so
+    // a 30% regression fails) and less than two random choices per truck
+    {
+        std::cout << "==== Test Case 12.2: Time Warp engine, 8 LPs on 1 vs 4 Threads, 4000 Trucks, 96 Stations ====\n";
+        Simulation<IndexedEventHeap, ProjectedFreeTimeSelection> sequentialSim(4000, 96, 6);
+        Simulation<IndexedEventHeap, PowerOfDChoicesSelection<2>> twoChoicesSim(4000, 96, 6);
+        TimeWarpSimulation<ProjectedFreeTimeSelection> aheadSim(4000, 96, 6, 8, 1, 1024);
+        TimeWarpSimulation<ProjectedFreeTimeSelection> lockstepSim(4000, 96, 6, 8, 4, 16);
+        sequentialSim.run();
+        twoChoicesSim.run();
+        aheadSim.run();
+        lockstepSim.run();
+
+        auto sequentialTotals = sequentialSim.getTrucks().totals();
+        auto twoChoicesTotals = twoChoicesSim.getTrucks().totals();
+        auto optimisticTotals = aheadSim.getTrucks().totals();
+        double sequentialWait = static_cast<double>(sequentialTotals.totalWaitTime) / sequentialTotals.loadsDelivered;
+        double twoChoicesWait = static_cast<double>(twoChoicesTotals.totalWaitTime) / twoChoicesTotals.loadsDelivered;
+        double optimisticWait = static_cast<double>(optimisticTotals.totalWaitTime) / optimisticTotals.loadsDelivered;
+        const TimeWarpStats &stats = aheadSim.getStats();
+        bool close = std::abs(optimisticTotals.loadsDelivered - sequentialTotals.loadsDelivered) <=
+                         sequentialTotals.loadsDelivered / 50 &&
+                     sequentialWait <= optimisticWait && optimisticWait <= 7.0 * sequentialWait &&
+                     optimisticWait <= twoChoicesWait;
+        bool same = sameTruckStatistics(aheadSim, lockstepSim) &&
+                    aheadSim.getEventsProcessed() == lockstepSim.getEventsProcessed();
+        std::cout << (same && close && stats.rollbacks > 0 ? "  PASS" : "  FAIL") << ": loads delivered "
+                  << sequentialTotals.loadsDelivered << " vs " << optimisticTotals.loadsDelivered
+                  << ", wait per load " << sequentialWait << " vs " << optimisticWait << " ("
+                  << optimisticWait / sequentialWait << "x; two random choices " << twoChoicesWait << "), "
+                  << stats.rollbacks << " rollbacks, rollback rate " << stats.rollbackRate()
+                  << ", efficiency " << stats.efficiency() << "\n\n";
+    }
+
+    // Test Case 12.3: the last round of a run leaves rollback logs behind, so
+    // a second run() must start over from fresh LPs and repeat the first
+    {
+        std::cout << "==== Test Case 12.3: Time Warp engine, run() twice, 4 LPs on 2 Threads, 500 Trucks, 12 Stations ====\n";
+        TimeWarpSimulation<> rerunSim(500, 12, 5, 4, 2);
+        TimeWarpSimulation<> freshSim(500, 12, 5, 4, 2);
+        rerunSim.run();
+        rerunSim.run();
+        freshSim.run();
+        bool same = sameTruckStatistics(rerunSim, freshSim) &&
+                    rerunSim.getEventsProcessed() == freshSim.getEventsProcessed();
+        std::cout << (same ? "  PASS" : "  FAIL") << ": second run delivered "
+                  << rerunSim.getTrucks().totals().loadsDelivered << " loads, same as a fresh engine\n\n";
+    }
+    /*
+     * ================================
+     * Test Case Class 13: lockstep replications
+     * ================================
+     */
+
+    // Test Case 13.1: every lane must be exactly the sequential simulation with
+    // the Xoshiro128Rng of that lane's seed, including lanes whose queues and
+    // event ties differ from their neighbours
+    {
+        std::cout << "==== Test Case 13.1: lockstep lanes vs Simulation, 5 Trucks / 2 Stations and 10 Trucks / 2+1+1 Bays ====\n";
+        using XoshiroSim = Simulation<IndexedEventHeap, ShortestQueueSelection, Xoshiro128Rng, int32_t>;
+        bool same = true;
+        const std::vector<std::vector<int>> scenarios = {{1, 1}, {2, 1, 1}};
+        const int fleets[] = {5, 10};
+        for (size_t scenario = 0; scenario < scenarios.size(); ++scenario)
+        {
+            const std::vector<int> &bays = scenarios[scenario];
+            LockstepReplications lockstep(fleets[scenario], bays);
+            lockstep.runLanes(40);
+            for (int lane = 0; lane < LockstepReplications::LANES; ++lane)
+            {
+                XoshiroSim sim(fleets[scenario], bays, 40 + lane);
+                sim.run();
+                for (int i = 0; i < fleets[scenario]; ++i)
+                {
+                    Truck expected = sim.getTrucks()[i];
+                    Truck actual = lockstep.getTruck(lane, i);
+                    same = same && actual.loadsDelivered == expected.loadsDelivered &&
+                           actual.totalWaitTime == expected.totalWaitTime &&
+                           actual.totalTravelTime == expected.totalTravelTime &&
+                           actual.totalMiningTime == expected.totalMiningTime &&
+                           actual.totalUnloadTime == expected.totalUnloadTime;
+                }
+                for (const auto &station : sim.getStations())
+                {
+                    same = same && lockstep.getStationBusyTime(lane, station.id) == station.totalBusyTime;
+                }
+            }
+        }
+        std::cout << (same ? "  PASS" : "  FAIL") << ": identical truck and station statistics in all "
+                  << LockstepReplications::LANES << " lanes\n\n";
+    }
+
+    // Test Case 13.2: run() must merge exactly what ReplicationRunner merges,
+    // including a last batch that fills only some lanes
+    {
+        std::cout << "==== Test Case 13.2: lockstep run() vs ReplicationRunner, 37 Replications, 3 Trucks, 1 Station ====\n";
+        using XoshiroSim = Simulation<IndexedEventHeap, ShortestQueueSelection, Xoshiro128Rng, int32_t>;
+        ReplicationRunner<XoshiroSim> runner(3, 1, SimulationOptions(), SiteTiming(), 1);
+        LockstepReplications lockstep(3, 1);
+        ReplicationSummary expected = runner.run(37, 7);
+        ReplicationSummary actual = lockstep.run(37, 7);
+        bool same = sameSummary(expected, actual) && actual.replications() == 37;
+        std::cout << (same ? "  PASS" : "  FAIL") << ": fleet loads " << actual.fleetLoads.mean() << " vs "
+                  << expected.fleetLoads.mean() << " per replication\n\n";
+    }
+    /*
+     * ================================
+     * Test Case Class 14: counter-based random streams
+     * ================================
+     */
+
+    // Test Case 14.1: PhiloxRng::block must match the Philox4x32-10 known-answer
+    // vectors of the reference implementation (Random123)
+    {
+        std::cout << "==== Test Case 14.1: Philox4x32-10 known-answer vectors ====\n";
+        struct KnownAnswer
+        {
+            uint32_t counter[4];
+            uint32_t key[2];
+            uint32_t expected[4];
+        };
+        const KnownAnswer answers[] = {
+            {{0, 0, 0, 0}, {0, 0}, {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}},
+            {{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+             {0xffffffff, 0xffffffff},
+             {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}},
+            {{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+             {0xa4093822, 0x299f31d0},
+             {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}},
+        };
+        bool same = true;
+        for (const KnownAnswer &answer : answers)
+        {
+            uint32_t out[4];
+            PhiloxRng::block(answer.counter, answer.key, out);
+            same = same && std::equal(out, out + 4, answer.expected);
+        }
+        std::cout << (same ? "  PASS" : "  FAIL") << ": all 3 vectors match\n\n";
+    }
+
+    // Test Case 14.2: with PhiloxRng each truck's mining times depend only on
+    // (seed, truck, cycle), whatever the event order: batched same-time
+    // handling, another queue and station policy, and both parallel engines
+    // with 4 LPs on 1 or 4 threads all draw exactly the per-cycle values
+    {
+        std::cout << "==== Test Case 14.2: PhiloxRng draws per (truck, cycle) in every engine, 500 Trucks, 12 Stations ====\n";
+        SimulationOptions batched;
+        batched.batchSameTime = true;
+        Simulation<IndexedEventHeap, ShortestQueueSelection, PhiloxRng> defaultSim(500, 12, 9);
+        Simulation<IndexedEventHeap, ShortestQueueSelection, PhiloxRng> batchedSim(500, 12, 9, batched);
+        Simulation<RadixEventQueue, ProjectedFreeTimeSelection, PhiloxRng> projectedSim(500, 12, 9);
+        using PhiloxParallelSim = ConservativeParallelSimulation<BinaryHeapEventQueue, ShortestQueueSelection, PhiloxRng>;
+        PhiloxParallelSim serialSim(500, 12, 9, 4, 1);
+        PhiloxParallelSim parallelSim(500, 12, 9, 4, 4);
+        TimeWarpSimulation<ShortestQueueSelection, PhiloxRng> aheadSim(500, 12, 9, 4, 1);
+        TimeWarpSimulation<ShortestQueueSelection, PhiloxRng> lockstepSim(500, 12, 9, 4, 4, 16);
+        defaultSim.run();
+        batchedSim.run();
+        projectedSim.run();
+        serialSim.run();
+        parallelSim.run();
+        aheadSim.run();
+        lockstepSim.run();
+        bool same = miningFollowsCycles(defaultSim, 9) && miningFollowsCycles(batchedSim, 9) &&
+                    miningFollowsCycles(projectedSim, 9) && miningFollowsCycles(serialSim, 9) &&
+                    miningFollowsCycles(parallelSim, 9) && sameTruckStatistics(serialSim, parallelSim) &&
+                    miningFollowsCycles(aheadSim, 9) && miningFollowsCycles(lockstepSim, 9) &&
+                    sameTruckStatistics(aheadSim, lockstepSim);
+        std::cout << (same ? "  PASS" : "  FAIL") << ": every truck mined its own (seed, truck, cycle) draws\n\n";
+    }
+    /*
+     * ================================
+     * Test Case Class 15: buffered mining-time draws
+     * ================================
+     */
+
+    // Test Case 15.1: the vector refill must produce exactly the lane-interleaved
+    // draws of scalar Xoshiro128Rng streams, across several refills and after
+    // a reset to another seed
+    {
+        std::cout << "==== Test Case 15.1: BufferedXoshiroRng vs interleaved Xoshiro128Rng, 3 Refills ====\n";
+        BufferedXoshiroRng buffered(11);
+        bool same = true;
+        for (unsigned seed : {11u, 12u})
+        {
+            if (seed != 11u)
+            {
+                buffered.reset(seed);
+            }
+            std::vector<Xoshiro128Rng> lanes;
+            for (int lane = 0; lane < BufferedXoshiroRng::LANES; ++lane)
+            {
+                lanes.emplace_back(static_cast<uint64_t>(lane) << 32 | seed);
+            }
+            for (int i = 0; i < 3 * BufferedXoshiroRng::BUFFER_SIZE; ++i)
+            {
+                same = same && buffered.miningTime(0, 0) == lanes[i % BufferedXoshiroRng::LANES].miningTime(0, 0);
+            }
+        }
+        std::cout << (same ? "  PASS" : "  FAIL") << ": identical draws over " << BufferedXoshiroRng::LANES << " lanes on every build\n\n";
+    }
+
+    // Test Case 15.2: a simulation drawing from the buffer starts over cleanly
+    // on reset(), and its draws stay in the mining range
+    {
+        std::cout << "==== Test Case 15.2: Simulation with BufferedXoshiroRng, reset() and mining range, 500 Trucks, 12 Stations ====\n";
+        using BufferedSim = Simulation<IndexedEventHeap, ShortestQueueSelection, BufferedXoshiroRng>;
+        bool reusable = resetMatchesFresh<BufferedSim>(500, 12);
+        BufferedSim sim(500, 12, 3);
+        sim.run();
+        bool inRange = true;
+        for (const Truck &truck : sim.getTrucks())
+        {
+            inRange = inRange && truck.totalMiningTime >= MINING_TIME_MIN * truck.loadsDelivered &&
+                      truck.totalMiningTime <= MINING_TIME_MAX * truck.loadsDelivered;
+        }
+        std::cout << (reusable && inRange ? "  PASS" : "  FAIL")
+                  << ": reset() matches a fresh run, mining times within range\n\n";
+    }
+    /*
+     * ================================
+     * Test Case Class 16: paired comparisons
+     * ================================
+     */
+
+    // Test Case 16.1: with common random numbers the loads delivered by the two
+    // sides move together, so the CI of their difference must be several times
+    // narrower than independent runs would give; the summed samples must not
+    // depend on the thread count, and each side must match its own SweepEngine run
+    {
+        std::cout << "==== Test Case 16.1: PairedComparison, 30 Trucks, 1 vs 2 Stations, 40 Replications, 1 vs 3 Threads ====\n";
+        SweepPoint baseline{30, 1, SiteTiming()};
+        SweepPoint alternative{30, 2, SiteTiming()};
+        PairedComparison<> serial(SimulationOptions(), 1);
+        PairedComparison<> parallel(SimulationOptions(), 3);
+        PairedComparisonResult serialResult = serial.run(baseline, alternative, 40, 5);
+        PairedComparisonResult parallelResult = parallel.run(baseline, alternative, 40, 5);
+
+        SweepEngine<Simulation<IndexedEventHeap, ShortestQueueSelection, PhiloxRng>> sweep(SimulationOptions(), 1);
+        std::vector<SweepResult> sides = sweep.run({baseline, alternative}, 40, 5);
+
+        auto same = [](const SampleMoments &x, const SampleMoments &y) {
+            return x.count == y.count && x.sum == y.sum && x.sumSquares == y.sumSquares;
+        };
+        const PairedStatistic &loads = serialResult.loadsDelivered;
+        bool threadIndependent = same(loads.difference, parallelResult.loadsDelivered.difference) &&
+                                 same(serialResult.waitPerLoad.difference, parallelResult.waitPerLoad.difference);
+        bool sidesMatch = same(loads.baseline, sides[0].loadsDelivered) &&
+                          same(loads.alternative, sides[1].loadsDelivered) &&
+                          std::abs(serialResult.waitPerLoad.baseline.mean() - sides[0].waitPerLoad.mean()) < 1e-9;
+        bool narrower = 2.0 * loads.difference.halfWidth95() < loads.unpairedHalfWidth95();
+        std::cout << (threadIndependent && sidesMatch && narrower ? "  PASS" : "  FAIL")
+                  << ": loads delivered difference " << loads.difference.mean() << " +/- "
+                  << loads.difference.halfWidth95() << " (independent runs: +/- " << loads.unpairedHalfWidth95()
+                  << ")\n\n";
+    }
+
+    // Test Case 16.2: an invalid configuration on either side must be refused
+    // before any replication runs, with an exception the caller can catch
+    {
+        std::cout << "==== Test Case 16.2: PairedComparison rejects an invalid configuration ====\n";
+        SiteTiming reversed;
+        reversed.miningTimeMin = 10;
+        reversed.miningTimeMax = 5;
+        PairedComparison<> comparison(SimulationOptions(), 2);
+        int rejected = 0;
+        for (const SweepPoint &bad : {SweepPoint{30, 1, reversed}, SweepPoint{-1, 1, SiteTiming()}})
+        {
+            try
+            {
+                comparison.run(SweepPoint{30, 1, SiteTiming()}, bad, 4, 1);
+            }
+            catch (const std::invalid_argument &)
+            {
+                ++rejected;
+            }
+        }
+        std::cout << (rejected == 2 ? "  PASS" : "  FAIL") << ": " << rejected << " of 2 invalid configurations rejected\n\n";
+    }
     return 0;
 }